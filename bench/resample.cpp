@@ -0,0 +1,132 @@
+/*
+    resample.cpp
+
+    Compares resampling a cursor frame with a cairo pattern, like loadThemeStyle used to,
+    against the built-in resampler with every kernel this machine can run, at common cursor sizes.
+    Speedup is the best kernel's.
+*/
+
+#include <iostream>
+#include <chrono>
+#include <random>
+#include <format>
+#include <vector>
+#include <cairo/cairo.h>
+#include "resample.hpp"
+
+static cairo_surface_t* makeSource(int side) {
+    const auto          SURFACE = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, side, side);
+    const auto          DATA    = (uint32_t*)cairo_image_surface_get_data(SURFACE);
+    const int           STRIDE  = cairo_image_surface_get_stride(SURFACE) / 4;
+
+    std::mt19937        rng{1337};
+
+    // something cursor-like: an opaque blob with soft edges, premultiplied
+    const float         CENTER = side / 2.F;
+    for (int y = 0; y < side; ++y) {
+        for (int x = 0; x < side; ++x) {
+            const float    DIST = std::hypot(x - CENTER, y - CENTER) / CENTER;
+            const uint32_t A    = DIST < 0.8F ? 255 : DIST < 1.F ? (uint32_t)(255 * (1.F - DIST) / 0.2F) : 0;
+
+            uint32_t       px = A << 24;
+            for (int c = 0; c < 3; ++c) {
+                px |= (A ? rng() % (A + 1) : 0) << (c * 8);
+            }
+
+            DATA[y * STRIDE + x] = px;
+        }
+    }
+
+    cairo_surface_mark_dirty(SURFACE);
+
+    return SURFACE;
+}
+
+// what renderStyleFrame did before the resampler, and still does for opaque pngs
+static void resampleCairo(cairo_surface_t* src, int srcSide, cairo_surface_t* dst, int dstSide, eHyprcursorResizeAlgo algo) {
+    const auto PCAIRO = cairo_create(dst);
+    const bool SMOOTH = algo == HC_RESIZE_BILINEAR || algo == HC_RESIZE_BOX || algo == HC_RESIZE_LANCZOS;
+
+    cairo_set_antialias(PCAIRO, SMOOTH ? CAIRO_ANTIALIAS_GOOD : CAIRO_ANTIALIAS_NONE);
+
+    cairo_save(PCAIRO);
+    cairo_set_operator(PCAIRO, CAIRO_OPERATOR_CLEAR);
+    cairo_paint(PCAIRO);
+    cairo_restore(PCAIRO);
+
+    const auto PTN = cairo_pattern_create_for_surface(src);
+    cairo_pattern_set_extend(PTN, CAIRO_EXTEND_NONE);
+    const float scale = dstSide / (float)srcSide;
+    cairo_scale(PCAIRO, scale, scale);
+    cairo_pattern_set_filter(PTN, SMOOTH ? CAIRO_FILTER_GOOD : CAIRO_FILTER_NEAREST);
+    cairo_set_source(PCAIRO, PTN);
+
+    cairo_rectangle(PCAIRO, 0, 0, dstSide, dstSide);
+
+    cairo_fill(PCAIRO);
+    cairo_surface_flush(dst);
+
+    cairo_pattern_destroy(PTN);
+    cairo_destroy(PCAIRO);
+}
+
+template <typename F>
+static double usPerFrame(size_t rounds, F&& fn) {
+    const auto BEGIN = std::chrono::steady_clock::now();
+
+    for (size_t r = 0; r < rounds; ++r) {
+        fn();
+    }
+
+    const auto END = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double, std::micro>(END - BEGIN).count() / (double)rounds;
+}
+
+int main(int argc, char** argv) {
+    const auto KERNELS = Resample::availableKernels();
+
+    std::cout << std::format("{:>12} {:>10} {:>14}", "size", "algo", "cairo (us)");
+    for (auto& k : KERNELS) {
+        std::cout << std::format(" {:>14}", std::format("{} (us)", k));
+    }
+    std::cout << std::format(" {:>8}\n", "speedup");
+
+    struct SCase {
+        int srcSide, dstSide;
+    };
+
+    for (auto [srcSide, dstSide] : {SCase{256, 24}, SCase{256, 32}, SCase{256, 48}, SCase{128, 96}, SCase{96, 48}, SCase{48, 64}, SCase{64, 128}}) {
+        const auto SOURCE = makeSource(srcSide);
+        const auto TARGET = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, dstSide, dstSide);
+
+        // about the same amount of work for every size
+        const size_t ROUNDS = std::max((size_t)20, (size_t)(20000000 / (srcSide * srcSide + dstSide * dstSide * 16)));
+
+        for (auto algo : {HC_RESIZE_NEAREST, HC_RESIZE_BILINEAR, HC_RESIZE_BOX, HC_RESIZE_LANCZOS}) {
+            const double CAIRO = usPerFrame(ROUNDS, [&]() { resampleCairo(SOURCE, srcSide, TARGET, dstSide, algo); });
+            const char*  NAME  = algo == HC_RESIZE_NEAREST ? "nearest" : algo == HC_RESIZE_BILINEAR ? "bilinear" : algo == HC_RESIZE_BOX ? "box" : "lanczos";
+
+            std::cout << std::format("{:>12} {:>10} {:>14.2f}", std::format("{}->{}", srcSide, dstSide), NAME, CAIRO);
+
+            double ours = 0;
+            for (auto& k : KERNELS) {
+                Resample::useKernels(k);
+
+                ours = usPerFrame(ROUNDS, [&]() {
+                    Resample::resample(cairo_image_surface_get_data(SOURCE), srcSide, srcSide, cairo_image_surface_get_stride(SOURCE), cairo_image_surface_get_data(TARGET),
+                                       dstSide, dstSide, cairo_image_surface_get_stride(TARGET), algo);
+                });
+
+                std::cout << std::format(" {:>14.2f}", ours);
+            }
+
+            std::cout << std::format(" {:>7.1f}x\n", CAIRO / ours);
+        }
+
+        cairo_surface_destroy(TARGET);
+        cairo_surface_destroy(SOURCE);
+    }
+
+    return 0;
+}
@@ -0,0 +1,89 @@
+/*
+    shape_lookup.cpp
+
+    Compares resolving a shape name by scanning the theme,
+    like getShapesC used to, against the shape index.
+*/
+
+#include <iostream>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <format>
+#include "shapeIndex.hpp"
+
+static SCursorTheme makeTheme(size_t names) {
+    SCursorTheme theme;
+
+    // roughly what real themes look like: every shape has a few aliases
+    constexpr size_t OVERRIDES = 3;
+
+    for (size_t i = 0; i < names; i += 1 + OVERRIDES) {
+        auto& shape     = theme.shapes.emplace_back(std::make_unique<SCursorShape>());
+        shape->directory = std::format("shape_{}", i);
+
+        for (size_t o = 1; o <= OVERRIDES && i + o < names; ++o) {
+            shape->overrides.push_back(std::format("alias_{}_{}", i, o));
+        }
+    }
+
+    return theme;
+}
+
+static SCursorShape* linearFind(const SCursorTheme& theme, const std::string& name) {
+    for (auto& shape : theme.shapes) {
+        if (name != shape->directory && std::find(shape->overrides.begin(), shape->overrides.end(), name) == shape->overrides.end())
+            continue;
+
+        return shape.get();
+    }
+
+    return nullptr;
+}
+
+template <typename F>
+static double nsPerLookup(const std::vector<std::string>& queries, size_t rounds, F&& fn) {
+    size_t     found = 0;
+
+    const auto BEGIN = std::chrono::steady_clock::now();
+
+    for (size_t r = 0; r < rounds; ++r) {
+        for (auto& q : queries) {
+            found += fn(q) != nullptr;
+        }
+    }
+
+    const auto END = std::chrono::steady_clock::now();
+
+    if (found != queries.size() * rounds)
+        std::cerr << "lookup missed a name!\n";
+
+    return std::chrono::duration<double, std::nano>(END - BEGIN).count() / (double)(queries.size() * rounds);
+}
+
+int main(int argc, char** argv) {
+    for (size_t names : {100, 5000}) {
+        const auto               THEME = makeTheme(names);
+
+        std::vector<std::string> queries;
+        for (auto& shape : THEME.shapes) {
+            queries.push_back(shape->directory);
+            queries.insert(queries.end(), shape->overrides.begin(), shape->overrides.end());
+        }
+
+        std::shuffle(queries.begin(), queries.end(), std::mt19937{1337});
+
+        CShapeIndex index;
+        index.build(THEME);
+
+        // about the same amount of total lookups for both sizes
+        const size_t ROUNDS = std::max((size_t)1, 2000000 / names);
+
+        const double LINEAR  = nsPerLookup(queries, std::max((size_t)1, ROUNDS / 50), [&](const std::string& q) { return linearFind(THEME, q); });
+        const double INDEXED = nsPerLookup(queries, ROUNDS, [&](const std::string& q) { const auto ENTRY = index.find(q); return ENTRY ? ENTRY->shape : nullptr; });
+
+        std::cout << std::format("{:>5} names: linear {:>10.1f} ns/lookup, indexed {:>6.1f} ns/lookup\n", names, LINEAR, INDEXED);
+    }
+
+    return 0;
+}
@@ -11,6 +11,7 @@
 #include "internalSharedTypes.hpp"
 #include "manifest.hpp"
 #include "meta.hpp"
+#include "themePack.hpp"
 
 #ifndef ZIP_LENGTH_TO_END
 #define ZIP_LENGTH_TO_END -1
@@ -22,6 +23,7 @@ enum eOperation : uint8_t {
 };
 
 static eHyprcursorResizeAlgo explicitResizeAlgo = HC_RESIZE_INVALID;
+static bool                  writePack          = false;
 
 struct XCursorConfigEntry {
     int         size = 0, hotspotX = 0, hotspotY = 0, delay = 0;
@@ -151,10 +153,11 @@ static std::optional<std::string> createCursorThemeFromPath(const std::string& p
         if (SHAPE->images.empty())
             return "meta invalid: no images for shape " + dir.path().stem().string();
 
-        SHAPE->directory  = dir.path().stem().string();
-        SHAPE->hotspotX   = meta.parsedData.hotspotX;
-        SHAPE->hotspotY   = meta.parsedData.hotspotY;
-        SHAPE->resizeAlgo = stringToAlgo(meta.parsedData.resizeAlgo);
+        SHAPE->directory   = dir.path().stem().string();
+        SHAPE->hotspotX    = meta.parsedData.hotspotX;
+        SHAPE->hotspotY    = meta.parsedData.hotspotY;
+        SHAPE->nominalSize = meta.parsedData.nominalSize;
+        SHAPE->resizeAlgo  = stringToAlgo(meta.parsedData.resizeAlgo);
 
         std::cout << "Shape " << SHAPE->directory << ": \n\toverrides: " << SHAPE->overrides.size() << "\n\tsizes: " << SHAPE->images.size() << "\n";
     }
@@ -202,9 +205,14 @@ static std::optional<std::string> createCursorThemeFromPath(const std::string& p
             zip_source_t* image = zip_source_file(zip, (CURRENTCURSORSDIR + "/" + i.filename).c_str(), 0, ZIP_LENGTH_TO_END);
             if (!image)
                 return "(1) failed to add image " + (CURRENTCURSORSDIR + "/" + i.filename) + " to hlc";
-            if (zip_file_add(zip, (i.filename).c_str(), image, ZIP_FL_ENC_UTF_8) < 0)
+            const auto INDEX = zip_file_add(zip, (i.filename).c_str(), image, ZIP_FL_ENC_UTF_8);
+            if (INDEX < 0)
                 return "(2) failed to add image " + i.filename + " to hlc";
 
+            // pngs are already compressed, storing them lets libhyprcursor use them straight from the file
+            if (i.filename.ends_with(".png") && zip_set_file_compression(zip, INDEX, ZIP_CM_STORE, 0) < 0)
+                return "(3) failed to set compression for image " + i.filename;
+
             std::cout << "Added image " << i.filename << " to shape " << shape->directory << "\n";
         }
 
@@ -217,6 +225,15 @@ static std::optional<std::string> createCursorThemeFromPath(const std::string& p
         std::cout << "Written " << OUTPUTFILE << "\n";
     }
 
+    if (writePack) {
+        const auto PACKFILE = out + "/" + CURSORSSUBDIR + ".hcpack";
+
+        if (const auto RET = CThemePack::write(PACKFILE, currentTheme, CURSORDIR, CThemePack::sourceStamp(out + "/" + CURSORSSUBDIR)); RET.has_value())
+            return "Failed to write pack: " + *RET;
+
+        std::cout << "Written " << PACKFILE << "\n";
+    }
+
     // done!
     std::cout << "Done, written " << currentTheme.shapes.size() << " shapes.\n";
 
@@ -429,6 +446,9 @@ int main(int argc, char** argv, char** envp) {
         } else if (arg == "--resize") {
             explicitResizeAlgo = stringToAlgo(argv[++i]);
             continue;
+        } else if (arg == "--pack") {
+            writePack = true;
+            continue;
         } else {
             std::cerr << "Unknown arg: " << arg << "\n";
             return 1;
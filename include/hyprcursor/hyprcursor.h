@@ -12,6 +12,8 @@
 
 #endif
 
+#include <stdint.h>
+
 #include "shared.h"
 
 struct hyprcursor_manager_t;
@@ -21,7 +23,8 @@ struct hyprcursor_manager_t;
 */
 struct hyprcursor_cursor_style_info {
     /*!
-        Shape size.
+        Shape size, in device pixels. Where a scale is taken alongside it, it's the logical size instead,
+        see hyprcursor_style_pixel_size.
         0 means "any" or "unspecified".
     */
     unsigned int size;
@@ -81,6 +84,75 @@ CAPI int hyprcursor_load_theme_style(struct hyprcursor_manager_t* manager, struc
 CAPI hyprcursor_cursor_image_data** hyprcursor_get_cursor_image_data(struct hyprcursor_manager_t* manager, const char* shape, struct hyprcursor_cursor_style_info info,
                                                                      int* out_size);
 
+/*!
+    \since 0.1.14
+
+    Returns the images for a given cursor shape and size, without allocating anything.
+
+    The images are owned by the manager and must not be freed. They stay valid until
+    hyprcursor_load_theme_style() or hyprcursor_style_done() is called for the size,
+    or the theme is reloaded. Without a loaded style for the size, trimming invalidates them too.
+
+    If the shape doesn't exist, len is 0.
+*/
+CAPI hyprcursor_cursor_image_data_view hyprcursor_get_cursor_image_data_view(struct hyprcursor_manager_t* manager, const char* shape,
+                                                                             struct hyprcursor_cursor_style_info info);
+
+/*!
+    \since 0.1.14
+
+    Returns the images of many shapes at once for a given size, see hyprcursor_get_cursor_image_data_view.
+
+    The result is one block, free it with hyprcursor_cursor_image_data_batch_free().
+    Surfaces stay valid until hyprcursor_style_done() is called for the size.
+*/
+CAPI hyprcursor_cursor_image_data_batch* hyprcursor_get_cursor_image_data_batch(struct hyprcursor_manager_t* manager, const char* const* shapes, unsigned long int len,
+                                                                                struct hyprcursor_cursor_style_info info);
+
+/*!
+    \since 0.1.14
+
+    Like hyprcursor_get_cursor_image_data_batch, but for shape handles.
+*/
+CAPI hyprcursor_cursor_image_data_batch* hyprcursor_get_cursor_image_data_batch_for_handles(struct hyprcursor_manager_t* manager, const unsigned int* handles,
+                                                                                            unsigned long int len, struct hyprcursor_cursor_style_info info);
+
+/*!
+    \since 0.1.14
+
+    Frees a batch returned by hyprcursor_get_cursor_image_data_batch.
+*/
+CAPI void hyprcursor_cursor_image_data_batch_free(hyprcursor_cursor_image_data_batch* batch);
+
+/*!
+    \since 0.1.14
+
+    Returns a handle for a shape name or override, or 0 if the theme doesn't have it.
+
+    If the theme doesn't know the name, but it's a wp_cursor_shape_v1 or common xcursor name,
+    it's resolved like hyprcursor_get_cursor_shape_v1_handle would.
+
+    Handles stay valid until the theme is reloaded.
+*/
+CAPI unsigned int hyprcursor_get_shape_handle(struct hyprcursor_manager_t* manager, const char* shape);
+
+/*!
+    \since 0.1.14
+
+    Returns a handle for a wp_cursor_shape_device_v1 shape enum value, or 0 if the theme has no such shape.
+
+    Handles stay valid until the theme is reloaded.
+*/
+CAPI unsigned int hyprcursor_get_cursor_shape_v1_handle(struct hyprcursor_manager_t* manager, uint32_t shape);
+
+/*!
+    \since 0.1.14
+
+    Like hyprcursor_get_cursor_image_data_view, but for a shape handle.
+*/
+CAPI hyprcursor_cursor_image_data_view hyprcursor_get_cursor_image_data_view_for_handle(struct hyprcursor_manager_t* manager, unsigned int handle,
+                                                                                        struct hyprcursor_cursor_style_info info);
+
 /*!
     Free a returned hyprcursor_cursor_image_data.
 */
@@ -119,4 +191,154 @@ CAPI hyprcursor_cursor_raw_shape_data* hyprcursor_get_raw_shape_data(struct hypr
 */
 CAPI void hyprcursor_raw_shape_data_free(hyprcursor_cursor_raw_shape_data* data);
 
+/*!
+    \since 0.1.14
+
+    Lists the installed hyprcursor themes, in the order they would be picked.
+
+    Only manifests are read, no cursor shapes are loaded.
+
+    The list needs to be freed after using, see hyprcursor_theme_list_free()
+*/
+CAPI hyprcursor_theme_list* hyprcursor_get_themes(PHYPRCURSORLOGFUNC fn);
+
+/*!
+    \since 0.1.14
+
+    See hyprcursor_get_themes.
+    Frees the returned list.
+*/
+CAPI void hyprcursor_theme_list_free(hyprcursor_theme_list* list);
+
+/*!
+    \since 0.1.14
+
+    Starts watching the loaded theme and the theme directories for changes.
+
+    Returns a file descriptor to add to your event loop, or -1 on failure.
+    Once it's readable, call hyprcursor_manager_dispatch_theme_changes().
+    The fd is owned by the manager.
+*/
+CAPI int hyprcursor_manager_watch_theme_changes(struct hyprcursor_manager_t* manager);
+
+/*!
+    \since 0.1.14
+
+    Handles pending changes seen by the watcher.
+
+    Returns a mask of eHyprcursorThemeChange.
+    If HC_THEME_CHANGE_CURRENT is set, you probably want to call hyprcursor_manager_reload_theme().
+*/
+CAPI unsigned int hyprcursor_manager_dispatch_theme_changes(struct hyprcursor_manager_t* manager);
+
+/*!
+    \since 0.1.14
+
+    Finds and loads the theme again, as if the manager was created anew.
+
+    All styles and surfaces obtained before are invalid after this call.
+
+    Returns whether the manager is valid.
+*/
+CAPI int hyprcursor_manager_reload_theme(struct hyprcursor_manager_t* manager);
+
+/*!
+    \since 0.1.14
+
+    Frees the decoded surfaces of the theme's png images, keeping only their compressed data,
+    and the parsed documents of its svg images. They will be decoded again when needed.
+
+    Images a loaded style's shapes use are kept, so loaded styles are not affected.
+    Image data obtained for sizes without a loaded style is invalid after this call.
+*/
+CAPI void hyprcursor_manager_trim_decoded_surfaces(struct hyprcursor_manager_t* manager);
+
+/*!
+    \since 0.1.14
+
+    Loads the theme at a given style, like hyprcursor_load_theme_style, and returns a handle to it, or NULL on failure.
+
+    Styles are refcounted: every acquire (and hyprcursor_load_theme_style) for the same size returns the same style,
+    and it's freed once hyprcursor_style_release (or hyprcursor_style_done) was called as many times.
+
+    Each style has its own frames, styles of different sizes never affect each other.
+    Handles are invalid after the theme is reloaded.
+
+    info.size is the logical size and scale the output's, see hyprcursor_style_pixel_size for the size images are rendered at.
+*/
+CAPI hyprcursor_style* hyprcursor_style_acquire(struct hyprcursor_manager_t* manager, struct hyprcursor_cursor_style_info info, float scale);
+
+/*!
+    \since 0.1.14
+
+    Returns the size in device pixels a style for a logical size at a scale is rendered at,
+    see CHyprcursorManager::getStylePixelSize.
+*/
+CAPI unsigned int hyprcursor_style_pixel_size(struct hyprcursor_cursor_style_info info, float scale);
+
+/*!
+    \since 0.1.14
+
+    Returns the info of a style from hyprcursor_style_acquire, its size in device pixels.
+    That's what functions taking a hyprcursor_cursor_style_info without a scale take for the style.
+*/
+CAPI struct hyprcursor_cursor_style_info hyprcursor_style_get_info(struct hyprcursor_manager_t* manager, hyprcursor_style* style);
+
+/*!
+    \since 0.1.14
+
+    Drops a reference to a style from hyprcursor_style_acquire.
+*/
+CAPI void hyprcursor_style_release(struct hyprcursor_manager_t* manager, hyprcursor_style* style);
+
+/*!
+    \since 0.1.14
+
+    Like hyprcursor_get_cursor_image_data_view, but only looks at the given style's frames.
+*/
+CAPI hyprcursor_cursor_image_data_view hyprcursor_style_get_cursor_image_data_view(struct hyprcursor_manager_t* manager, hyprcursor_style* style, const char* shape);
+
+/*!
+    \since 0.1.14
+
+    Like hyprcursor_get_cursor_image_data_view_for_handle, but only looks at the given style's frames.
+*/
+CAPI hyprcursor_cursor_image_data_view hyprcursor_style_get_cursor_image_data_view_for_handle(struct hyprcursor_manager_t* manager, hyprcursor_style* style,
+                                                                                              unsigned int handle);
+
+/*!
+    \since 0.1.14
+
+    Like hyprcursor_style_acquire, but returns right away and renders the style on a background thread,
+    commonly used shapes first. Until a shape is rendered, the nearest size available is returned for it.
+
+    Rendered frames are added to the style in hyprcursor_manager_dispatch_style_loads, see hyprcursor_manager_watch_style_loads.
+*/
+CAPI hyprcursor_style* hyprcursor_style_acquire_async(struct hyprcursor_manager_t* manager, struct hyprcursor_cursor_style_info info, float scale);
+
+/*!
+    \since 0.1.14
+
+    Returns a file descriptor to add to your event loop, or -1 on failure.
+    Once it's readable, call hyprcursor_manager_dispatch_style_loads.
+    The fd is owned by the manager.
+*/
+CAPI int hyprcursor_manager_watch_style_loads(struct hyprcursor_manager_t* manager);
+
+/*!
+    \since 0.1.14
+
+    Adds frames rendered in the background to their styles. Returns how many styles finished loading.
+
+    Surfaces obtained for a style that was loading are invalid after this call, request them again.
+*/
+CAPI unsigned int hyprcursor_manager_dispatch_style_loads(struct hyprcursor_manager_t* manager);
+
+/*!
+    \since 0.1.14
+
+    Returns 1 if a style from hyprcursor_style_acquire_async is still rendering, 0 otherwise.
+*/
+CAPI int hyprcursor_style_loading(struct hyprcursor_manager_t* manager, hyprcursor_style* style);
+
 #endif
\ No newline at end of file
@@ -2,7 +2,11 @@
 
 #include <vector>
 #include <cstdlib>
+#include <cstdint>
 #include <string>
+#include <span>
+#include <cstddef>
+#include <string_view>
 
 #include "shared.h"
 
@@ -15,7 +19,8 @@ namespace Hyprcursor {
     */
     struct SCursorStyleInfo {
         /*!
-            Shape size.
+            Shape size, in device pixels. Where a scale is taken alongside it, it's the logical size instead,
+            see CHyprcursorManager::getStylePixelSize.
 
             0 means "any" or "unspecified".
         */
@@ -47,6 +52,90 @@ namespace Hyprcursor {
         eHyprcursorDataType               type        = HC_DATA_PNG;
     };
 
+    /*!
+        \since 0.1.14
+
+        A read-only look at a raw image, see getRawShapeDataView
+    */
+    struct SCursorRawShapeImageView {
+        std::span<const std::byte> data;
+        int                        size  = 0;
+        int                        delay = 200;
+    };
+
+    /*!
+        \since 0.1.14
+
+        A read-only look at a shape's raw data, see getRawShapeDataView
+    */
+    struct SCursorRawShapeDataView {
+        std::span<const SCursorRawShapeImageView> images;
+        /*!
+            Name of the shape the data belongs to. Differs from the requested name if that was an override.
+        */
+        std::string_view      shape;
+        float                 hotspotX    = 0;
+        float                 hotspotY    = 0;
+        float                 nominalSize = 1.F;
+        eHyprcursorResizeAlgo resizeAlgo  = HC_RESIZE_NONE;
+        eHyprcursorDataType   type        = HC_DATA_PNG;
+    };
+
+    /*!
+        \since 0.1.14
+
+        C++ struct for hyprcursor_theme_info
+    */
+    struct SThemeInfo {
+        std::string name, description, version, author, cursorsDirectory;
+        /*!
+            Name of the theme's directory. Both this and name can be used to create a manager.
+        */
+        std::string directory;
+        /*!
+            Canonical path of the theme's directory.
+        */
+        std::string path;
+    };
+
+    /*!
+        \since 0.1.14
+
+        Prefer getThemes, this is for C compat.
+        Free the result with freeThemesC.
+    */
+    SThemeListC* getThemesC(PHYPRCURSORLOGFUNC fn = nullptr);
+    void         freeThemesC(SThemeListC* list);
+
+    /*!
+        \since 0.1.14
+
+        Lists the installed hyprcursor themes, in the order they would be picked.
+
+        Only manifests are read, no cursor shapes are loaded, so this is much
+        cheaper than creating a manager per theme.
+    */
+    inline std::vector<SThemeInfo> getThemes(PHYPRCURSORLOGFUNC fn = nullptr) {
+        auto                    CLIST = getThemesC(fn);
+
+        std::vector<SThemeInfo> themes;
+
+        for (size_t i = 0; i < CLIST->len; ++i) {
+            const auto& T = CLIST->themes[i];
+            themes.emplace_back(SThemeInfo{.name             = T.name,
+                                           .description      = T.description,
+                                           .version          = T.version,
+                                           .author           = T.author,
+                                           .cursorsDirectory = T.cursorsDirectory,
+                                           .directory        = T.directory,
+                                           .path             = T.path});
+        }
+
+        freeThemesC(CLIST);
+
+        return themes;
+    }
+
     /*!
         struct for cursor manager options
     */
@@ -63,6 +152,71 @@ namespace Hyprcursor {
         bool allowDefaultFallback;
     };
 
+    /*!
+        \since 0.1.14
+
+        struct for the cursor manager's loading options, see CHyprcursorManager(const char*, const SManagerLoadOptions*).
+
+        SManagerOptions can't grow without breaking the ABI, so new options go here instead.
+        Fields are only ever appended, and structSize tells the library which ones the caller knows of.
+        The ones it doesn't keep their defaults.
+    */
+    struct SManagerLoadOptions {
+        /*!
+            Leave as is.
+        */
+        size_t structSize = sizeof(SManagerLoadOptions);
+        /*!
+            The function used for logging by the cursor manager
+        */
+        PHYPRCURSORLOGFUNC logFn = nullptr;
+        /*!
+            Allow fallback to env and first theme found
+        */
+        bool allowDefaultFallback = true;
+        /*!
+            Only read shape metadata when loading the theme. Images are read and decoded
+            the first time a shape is used, e.g. by getShape, getRawShapeData or loadThemeStyle.
+        */
+        bool lazyLoading = false;
+        /*!
+            How many threads to load the theme's shapes, and rasterize styles, on. 1 does everything on the calling thread.
+            The logging function can be called from these threads.
+        */
+        unsigned int loadThreads = 1;
+        /*!
+            Keep png images compressed in memory, and only decode them the first time
+            they're needed, e.g. by getShape or loadThemeStyle.
+
+            Saves a lot of memory with themes that have many sizes, at the cost
+            of a decode when a size is first used. See also trimDecodedSurfaces.
+        */
+        bool decodeOnDemand = false;
+        /*!
+            Make loadThemeStyle only register the size. A shape is rasterized for a style
+            the first time it's requested at that size, e.g. by getShape.
+
+            Makes loading a style nearly free, at the cost of a render on first use of each shape.
+        */
+        bool lazyStyles = false;
+        /*!
+            When a style needs a png shape much smaller than the sizes the theme has, resample it from
+            successive halvings of the largest size instead of from that size directly.
+
+            Makes the cost of a style independent of how large the theme's images are, and reduces aliasing.
+            Halvings are kept until trimDecodedSurfaces.
+        */
+        bool mipmaps = false;
+        /*!
+            Render every svg frame once into a display list (a cairo recording surface), and make
+            styles by replaying it scaled, instead of having librsvg walk the document for every size.
+
+            Cheaper for themes with many svg frames. Effects librsvg rasterizes itself, like filters,
+            are rasterized once at 256px and scaled. Display lists are kept until trimDecodedSurfaces.
+        */
+        bool svgDisplayLists = false;
+    };
+
     /*!
         Basic Hyprcursor manager.
 
@@ -85,6 +239,12 @@ namespace Hyprcursor {
         */
         CHyprcursorManager(const char* themeName, PHYPRCURSORLOGFUNC fn);
         CHyprcursorManager(const char* themeName, SManagerOptions options);
+        /*!
+            \since 0.1.14
+
+            options can't be nullptr, and is only read here.
+        */
+        CHyprcursorManager(const char* themeName, const SManagerLoadOptions* options);
         ~CHyprcursorManager();
 
         /*!
@@ -95,6 +255,7 @@ namespace Hyprcursor {
 
         /*!
             Loads this theme at a given style, synchronously.
+            With SManagerLoadOptions::lazyStyles, shapes are only rasterized when first requested.
 
             Returns whether it succeeded.
         */
@@ -109,26 +270,26 @@ namespace Hyprcursor {
             The surfaces references stay valid until cursorSurfaceStyleDone() is called on the owning style.
         */
         SCursorShapeData getShape(const char* shape, const SCursorStyleInfo& info) {
-            int                size   = 0;
-            SCursorImageData** images = getShapesC(size, shape, info);
+            const auto VIEW = getShapeView(shape, info);
 
-            SCursorShapeData   data;
+            return SCursorShapeData{.images = {VIEW.begin(), VIEW.end()}};
+        }
 
-            for (int i = 0; i < size; ++i) {
-                SCursorImageData image;
-                image.delay    = images[i]->delay;
-                image.size     = images[i]->size;
-                image.surface  = images[i]->surface;
-                image.hotspotX = images[i]->hotspotX;
-                image.hotspotY = images[i]->hotspotY;
-                data.images.push_back(image);
+        /*!
+            \since 0.1.14
 
-                free(images[i]);
-            }
+            Like getShape, but returns the images without allocating or copying anything.
 
-            free(images);
+            The view is owned by the manager. It stays valid until loadThemeStyle() or cursorSurfaceStyleDone()
+            is called for the style, or reloadTheme() is called. Without a loaded style for the size,
+            trimDecodedSurfaces() invalidates it too.
 
-            return data;
+            If the shape doesn't exist, the view is empty.
+        */
+        std::span<const SCursorImageData> getShapeView(const char* shape, const SCursorStyleInfo& info) {
+            const auto VIEW = getShapeViewC(shape, info);
+
+            return {VIEW.images, VIEW.len};
         }
 
         /*!
@@ -162,11 +323,105 @@ namespace Hyprcursor {
             return data;
         }
 
+        /*!
+            \since 0.1.14
+
+            Returns a handle for a shape name or override, or 0 if the theme doesn't have it.
+
+            If the theme doesn't know the name, but it's a wp_cursor_shape_v1 or common xcursor name,
+            it's resolved like getCursorShapeV1Handle would.
+
+            Handles stay valid until reloadTheme().
+        */
+        unsigned int getShapeHandle(const char* shape);
+
+        /*!
+            \since 0.1.14
+
+            Returns a handle for a wp_cursor_shape_device_v1 shape enum value, or 0 if the theme has no such shape.
+
+            Handles stay valid until reloadTheme().
+        */
+        unsigned int getCursorShapeV1Handle(uint32_t shape);
+
+        /*!
+            \since 0.1.14
+
+            Like getShapeView, but for a handle from getShapeHandle or getCursorShapeV1Handle.
+            No strings are looked at.
+        */
+        std::span<const SCursorImageData> getShapeViewForHandle(unsigned int handle, const SCursorStyleInfo& info) {
+            const auto VIEW = getShapeViewForHandleC(handle, info);
+
+            return {VIEW.images, VIEW.len};
+        }
+
+        /*!
+            \since 0.1.14
+
+            Returns the shape data of many shapes at once, in the order of shapes.
+            Shapes that weren't found have no images.
+        */
+        std::vector<SCursorShapeData> getShapes(const std::vector<const char*>& shapes, const SCursorStyleInfo& info) {
+            return batchToShapeData(getShapesBatchC(shapes.data(), shapes.size(), info));
+        }
+
+        /*!
+            \since 0.1.14
+
+            Like getShapes, but for handles from getShapeHandle or getCursorShapeV1Handle.
+        */
+        std::vector<SCursorShapeData> getShapes(const std::vector<unsigned int>& handles, const SCursorStyleInfo& info) {
+            return batchToShapeData(getShapesBatchForHandlesC(handles.data(), handles.size(), info));
+        }
+
+        /*!
+            \since 0.1.14
+
+            Like getRawShapeData, but nothing is copied: the views point into memory owned by the manager,
+            valid until reloadTheme() is called or the manager is destroyed.
+
+            Overrides are followed, so this returns the data of the shape that overrides the name.
+
+            If the shape doesn't exist, images is empty.
+        */
+        SCursorRawShapeDataView getRawShapeDataView(const char* shape);
+
         /*!
             Prefer getShape, this is for C compat.
         */
         SCursorImageData** getShapesC(int& outSize, const char* shape_, const SCursorStyleInfo& info);
 
+        /*!
+            \since 0.1.14
+
+            Prefer getShapeView, this is for C compat.
+        */
+        SCursorImageDataViewC getShapeViewC(const char* shape_, const SCursorStyleInfo& info);
+
+        /*!
+            \since 0.1.14
+
+            Prefer getShapeViewForHandle, this is for C compat.
+        */
+        SCursorImageDataViewC getShapeViewForHandleC(unsigned int handle, const SCursorStyleInfo& info);
+
+        /*!
+            \since 0.1.14
+
+            Prefer getShapes, this is for C compat.
+            The result is a single allocation, free it with free().
+        */
+        SCursorImageDataBatchC* getShapesBatchC(const char* const* shapes, size_t len, const SCursorStyleInfo& info);
+
+        /*!
+            \since 0.1.14
+
+            Prefer getShapes, this is for C compat.
+            The result is a single allocation, free it with free().
+        */
+        SCursorImageDataBatchC* getShapesBatchForHandlesC(const unsigned int* handles, size_t len, const SCursorStyleInfo& info);
+
         /*!
             Prefer getShapeData, this is for C compat.
         */
@@ -177,6 +432,128 @@ namespace Hyprcursor {
         */
         void cursorSurfaceStyleDone(const SCursorStyleInfo&);
 
+        /*!
+            \since 0.1.14
+
+            Loads this theme at a given style, like loadThemeStyle, and returns a handle to it, or nullptr on failure.
+
+            Styles are refcounted: every acquireStyle (and loadThemeStyle) for the same size returns the same style,
+            and it's freed once releaseStyle (or cursorSurfaceStyleDone) was called as many times.
+
+            Each style has its own frames, styles of different sizes never affect each other.
+            Handles are invalid after reloadTheme().
+
+            info.size is the logical size and scale the output's, see getStylePixelSize for the size images are rendered at.
+            Present the images at that scale, e.g. with wp_viewporter.
+        */
+        SCursorStyleC* acquireStyle(const SCursorStyleInfo& info, float scale = 1.F);
+
+        /*!
+            \since 0.1.14
+
+            Returns the size in device pixels a style for a logical size at a scale is rendered at.
+
+            That's info.size * scale, rounded to the nearest integer. scale may be fractional, 0 means 1.
+            Styles are kept by this size, so scales landing on the same one share a style.
+        */
+        static unsigned int getStylePixelSize(const SCursorStyleInfo& info, float scale = 1.F);
+
+        /*!
+            \since 0.1.14
+
+            Returns the info of a style from acquireStyle, its size in device pixels.
+            Entry points taking a SCursorStyleInfo without a scale (loadThemeStyle, getShape, getShapeView, cursorSurfaceStyleDone)
+            take device pixels, so this is what they take for the style.
+        */
+        SCursorStyleInfo getStyleInfo(SCursorStyleC* style);
+
+        /*!
+            \since 0.1.14
+
+            Drops a reference to a style from acquireStyle.
+        */
+        void releaseStyle(SCursorStyleC* style);
+
+        /*!
+            \since 0.1.14
+
+            Like acquireStyle, but returns right away and loads the style on a background thread:
+            source images are read, decoded and rendered there. Commonly used shapes (default, text, pointer)
+            are rendered first. Styles load one after another, in the order they were acquired.
+
+            SManagerLoadOptions::lazyStyles doesn't apply, every shape is rendered.
+
+            Until a shape is rendered, requesting it at this style's size returns the nearest size
+            available, from the theme or from other styles.
+
+            Rendered frames are added to the style in dispatchStyleLoads(), see watchStyleLoads().
+            acquireStyle or loadThemeStyle on a style that's loading waits for it.
+        */
+        SCursorStyleC* acquireStyleAsync(const SCursorStyleInfo& info, float scale = 1.F);
+
+        /*!
+            \since 0.1.14
+
+            Returns a file descriptor to add to your event loop, or -1 on failure.
+            It becomes readable when a style from acquireStyleAsync has new frames: call dispatchStyleLoads() then.
+            The fd is owned by the manager, and stays valid across reloadTheme().
+        */
+        int watchStyleLoads();
+
+        /*!
+            \since 0.1.14
+
+            Adds frames rendered in the background to their styles.
+
+            Returns how many styles finished loading. Shapes can become available before their style finishes,
+            so request them again after every dispatch. Surfaces obtained for a style that was loading
+            are invalid after this call.
+        */
+        unsigned int dispatchStyleLoads();
+
+        /*!
+            \since 0.1.14
+
+            Returns whether a style from acquireStyleAsync is still loading.
+        */
+        bool styleLoading(SCursorStyleC* style);
+
+        /*!
+            \since 0.1.14
+
+            Like getShapeView, but only looks at the given style's frames.
+        */
+        std::span<const SCursorImageData> getShapeView(SCursorStyleC* style, const char* shape) {
+            const auto VIEW = getStyleShapeViewC(style, shape);
+
+            return {VIEW.images, VIEW.len};
+        }
+
+        /*!
+            \since 0.1.14
+
+            Like getShapeViewForHandle, but only looks at the given style's frames.
+        */
+        std::span<const SCursorImageData> getShapeViewForHandle(SCursorStyleC* style, unsigned int handle) {
+            const auto VIEW = getStyleShapeViewForHandleC(style, handle);
+
+            return {VIEW.images, VIEW.len};
+        }
+
+        /*!
+            \since 0.1.14
+
+            Prefer getShapeView, this is for C compat.
+        */
+        SCursorImageDataViewC getStyleShapeViewC(SCursorStyleC* style, const char* shape_);
+
+        /*!
+            \since 0.1.14
+
+            Prefer getShapeViewForHandle, this is for C compat.
+        */
+        SCursorImageDataViewC getStyleShapeViewForHandleC(SCursorStyleC* style, unsigned int handle);
+
         /*!
             \since 0.1.6
 
@@ -186,9 +563,69 @@ namespace Hyprcursor {
         */
         void registerLoggingFunction(PHYPRCURSORLOGFUNC fn);
 
+        /*!
+            \since 0.1.14
+
+            Starts watching the loaded theme and the theme directories for changes.
+
+            Returns a file descriptor to add to your event loop, or -1 on failure.
+            Once it's readable, call dispatchThemeChanges().
+            The fd is owned by the manager.
+        */
+        int watchThemeChanges();
+
+        /*!
+            \since 0.1.14
+
+            Handles pending changes seen by the watcher, see watchThemeChanges().
+
+            Returns a mask of eHyprcursorThemeChange.
+            If HC_THEME_CHANGE_CURRENT is set, you probably want to call reloadTheme().
+        */
+        uint32_t dispatchThemeChanges();
+
+        /*!
+            \since 0.1.14
+
+            Finds and loads the theme again, as if the manager was created anew.
+
+            All styles and surfaces obtained before are invalid after this call,
+            load your styles again.
+
+            Returns valid().
+        */
+        bool reloadTheme();
+
+        /*!
+            \since 0.1.14
+
+            Frees the decoded surfaces of the theme's png images, keeping only their compressed data,
+            and the parsed documents of its svg images. They will be decoded again when needed.
+
+            Images a loaded style's shapes use are kept, so loaded styles and their views are not affected.
+            Surfaces and views obtained for sizes without a loaded style are invalid after this call.
+        */
+        void trimDecodedSurfaces();
+
       private:
         void                       init(const char* themeName_);
 
+        std::vector<SCursorShapeData> batchToShapeData(SCursorImageDataBatchC* batch) {
+            std::vector<SCursorShapeData> data;
+
+            if (!batch)
+                return data;
+
+            for (size_t i = 0; i < batch->len; ++i) {
+                data.emplace_back(SCursorShapeData{.images = {batch->shapes[i].images, batch->shapes[i].images + batch->shapes[i].len}});
+            }
+
+            free(batch);
+
+            return data;
+        }
+
+        // the layout has to stay as is, anything new goes in impl
         CHyprcursorImplementation* impl                 = nullptr;
         bool                       finalizedAndValid    = false;
         bool                       allowDefaultFallback = true;
@@ -16,6 +16,42 @@ struct SCursorImageData {
 
 typedef struct SCursorImageData hyprcursor_cursor_image_data;
 
+/*!
+    \since 0.1.14
+
+    A list of cursor images owned by the manager, see hyprcursor_get_cursor_image_data_view
+*/
+struct SCursorImageDataViewC {
+    const struct SCursorImageData* images;
+    unsigned long int              len;
+};
+
+typedef struct SCursorImageDataViewC hyprcursor_cursor_image_data_view;
+
+/*!
+    \since 0.1.14
+
+    A loaded style, owned by the manager. See hyprcursor_style_acquire
+*/
+struct SCursorStyleC;
+
+typedef struct SCursorStyleC hyprcursor_style;
+
+/*!
+    \since 0.1.14
+
+    Result of a batch query, see hyprcursor_get_cursor_image_data_batch.
+
+    shapes has one entry per requested shape, in order, with len 0 for shapes that weren't found.
+    Everything is one allocation.
+*/
+struct SCursorImageDataBatchC {
+    struct SCursorImageDataViewC* shapes;
+    unsigned long int             len;
+};
+
+typedef struct SCursorImageDataBatchC hyprcursor_cursor_image_data_batch;
+
 enum eHyprcursorLogLevel {
     HC_LOG_NONE = 0,
     HC_LOG_TRACE,
@@ -35,6 +71,21 @@ enum eHyprcursorResizeAlgo {
     HC_RESIZE_NONE,
     HC_RESIZE_BILINEAR,
     HC_RESIZE_NEAREST,
+    /*! \since 0.1.14 averages the source pixels each pixel covers */
+    HC_RESIZE_BOX,
+    /*! \since 0.1.14 sharpest, best for large reductions */
+    HC_RESIZE_LANCZOS,
+};
+
+/*!
+    \since 0.1.14
+
+    Flags returned when dispatching theme changes
+*/
+enum eHyprcursorThemeChange {
+    HC_THEME_CHANGE_NONE      = 0,
+    HC_THEME_CHANGE_CURRENT   = 1 << 0, /* the loaded theme was modified, replaced or removed */
+    HC_THEME_CHANGE_INSTALLED = 1 << 1, /* themes were installed or removed */
 };
 
 struct SCursorRawShapeImageC {
@@ -59,6 +110,30 @@ struct SCursorRawShapeDataC {
 
 typedef struct SCursorRawShapeDataC hyprcursor_cursor_raw_shape_data;
 
+/*!
+    \since 0.1.14
+
+    struct for an installed theme, as described by its manifest
+*/
+struct SThemeInfoC {
+    char* name;
+    char* description;
+    char* version;
+    char* author;
+    char* cursorsDirectory;
+    char* directory; /* name of the theme's directory */
+    char* path;      /* canonical path of the theme's directory */
+};
+
+typedef struct SThemeInfoC hyprcursor_theme_info;
+
+struct SThemeListC {
+    struct SThemeInfoC* themes;
+    unsigned long int   len;
+};
+
+typedef struct SThemeListC hyprcursor_theme_list;
+
 /*
     msg is owned by the caller and will be freed afterwards.
 */
@@ -3,6 +3,7 @@
 #include <string>
 #include <format>
 #include <iostream>
+#include <mutex>
 
 #include <hyprcursor/shared.h>
 
@@ -10,6 +11,9 @@ namespace Debug {
     inline bool quiet   = false;
     inline bool verbose = false;
 
+    // log functions can be called from worker threads
+    inline std::mutex logMutex;
+
     template <typename... Args>
     void log(eHyprcursorLogLevel level, PHYPRCURSORLOGFUNC fn, const std::string& fmt, Args&&... args) {
         if (!fn)
@@ -17,6 +21,7 @@ namespace Debug {
 
         const std::string LOG = std::vformat(fmt, std::make_format_args(args...));
 
+        std::lock_guard<std::mutex> lg(logMutex);
         fn(level, (char*)LOG.c_str());
     }
 };
\ No newline at end of file
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+#include <system_error>
+
+namespace Parallel {
+
+    /*
+        Runs fn(i) for every i in [0, count) on up to threads threads, including the caller's.
+        Indices are handed out in increasing order. Blocks until all are done.
+
+        If threads can't be started, the ones that did and the caller do the work.
+        fn must not throw.
+    */
+    template <typename F>
+    void forEach(size_t count, size_t threads, const F& fn) {
+        threads = std::min(threads, count);
+
+        if (threads <= 1) {
+            for (size_t i = 0; i < count; ++i) {
+                fn(i);
+            }
+            return;
+        }
+
+        std::atomic<size_t> next = 0;
+
+        const auto          WORKER = [&]() {
+            for (size_t i = next++; i < count; i = next++) {
+                fn(i);
+            }
+        };
+
+        std::vector<std::thread> pool;
+        pool.reserve(threads - 1);
+
+        try {
+            for (size_t i = 1; i < threads; ++i) {
+                pool.emplace_back(WORKER);
+            }
+        } catch (std::system_error& e) {
+            // out of threads, fewer workers will do
+        }
+
+        WORKER();
+
+        for (auto& t : pool) {
+            t.join();
+        }
+    }
+}
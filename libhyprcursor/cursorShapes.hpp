@@ -0,0 +1,226 @@
+#pragma once
+
+#include <array>
+#include <string_view>
+#include <cstdint>
+
+/*
+    Names of the wp_cursor_shape_device_v1 shapes, and the xcursor names commonly used for them.
+
+    Values are the protocol's enum values, 0 is not a shape.
+*/
+
+namespace CursorShapes {
+    constexpr uint32_t SHAPE_COUNT = 37; // including 0, up to all_resize from v2
+
+    struct SName {
+        std::string_view name;
+        uint32_t         shape = 0;
+    };
+
+    // the css name of each shape comes first, themes made from xcursor themes use the rest
+    constexpr SName NAMES[] = {
+        {"default", 1},
+        {"left_ptr", 1},
+        {"arrow", 1},
+        {"top_left_arrow", 1},
+        {"left_arrow", 1},
+        {"context-menu", 2},
+        {"help", 3},
+        {"question_arrow", 3},
+        {"whats_this", 3},
+        {"left_ptr_help", 3},
+        {"pointer", 4},
+        {"hand2", 4},
+        {"hand1", 4},
+        {"hand", 4},
+        {"pointing_hand", 4},
+        {"progress", 5},
+        {"left_ptr_watch", 5},
+        {"half-busy", 5},
+        {"wait", 6},
+        {"watch", 6},
+        {"cell", 7},
+        {"plus", 7},
+        {"crosshair", 8},
+        {"cross", 8},
+        {"tcross", 8},
+        {"text", 9},
+        {"xterm", 9},
+        {"ibeam", 9},
+        {"vertical-text", 10},
+        {"alias", 11},
+        {"link", 11},
+        {"dnd-link", 11},
+        {"copy", 12},
+        {"dnd-copy", 12},
+        {"move", 13},
+        {"dnd-move", 13},
+        {"no-drop", 14},
+        {"dnd-no-drop", 14},
+        {"not-allowed", 15},
+        {"crossed_circle", 15},
+        {"forbidden", 15},
+        {"circle", 15},
+        {"grab", 16},
+        {"openhand", 16},
+        {"grabbing", 17},
+        {"closedhand", 17},
+        {"dnd-none", 17},
+        {"e-resize", 18},
+        {"right_side", 18},
+        {"n-resize", 19},
+        {"top_side", 19},
+        {"ne-resize", 20},
+        {"top_right_corner", 20},
+        {"nw-resize", 21},
+        {"top_left_corner", 21},
+        {"s-resize", 22},
+        {"bottom_side", 22},
+        {"se-resize", 23},
+        {"bottom_right_corner", 23},
+        {"sw-resize", 24},
+        {"bottom_left_corner", 24},
+        {"w-resize", 25},
+        {"left_side", 25},
+        {"ew-resize", 26},
+        {"sb_h_double_arrow", 26},
+        {"h_double_arrow", 26},
+        {"size_hor", 26},
+        {"ns-resize", 27},
+        {"sb_v_double_arrow", 27},
+        {"v_double_arrow", 27},
+        {"size_ver", 27},
+        {"nesw-resize", 28},
+        {"fd_double_arrow", 28},
+        {"size_bdiag", 28},
+        {"nwse-resize", 29},
+        {"bd_double_arrow", 29},
+        {"size_fdiag", 29},
+        {"col-resize", 30},
+        {"split_h", 30},
+        {"row-resize", 31},
+        {"split_v", 31},
+        {"all-scroll", 32},
+        {"fleur", 32},
+        {"size_all", 32},
+        {"zoom-in", 33},
+        {"zoom_in", 33},
+        {"zoom-out", 34},
+        {"zoom_out", 34},
+        {"dnd-ask", 35},
+        {"all-resize", 36},
+    };
+
+    constexpr size_t NAME_COUNT = sizeof(NAMES) / sizeof(NAMES[0]);
+
+    constexpr uint64_t hash(std::string_view s, uint64_t seed) {
+        // fnv-1a, seeded
+        uint64_t h = 0xcbf29ce484222325ULL ^ (seed * 0x9E3779B97F4A7C15ULL);
+        for (char c : s) {
+            h ^= (uint8_t)c;
+            h *= 0x100000001b3ULL;
+        }
+        return h ^ (h >> 29);
+    }
+
+    /*
+        Perfect hash over NAMES, built at compile time with hash and displace:
+        names are split into buckets, and each bucket gets a seed that puts
+        all of its names into free slots.
+    */
+    constexpr size_t BUCKETS = 32;
+    constexpr size_t SLOTS   = 128;
+
+    struct SPerfectHash {
+        std::array<uint16_t, BUCKETS> seeds{};
+        std::array<int16_t, SLOTS>    slots{}; // index into NAMES, -1 if empty
+    };
+
+    constexpr SPerfectHash buildPerfectHash() {
+        SPerfectHash result;
+        result.slots.fill(-1);
+
+        std::array<size_t, BUCKETS> bucketSizes{};
+        for (size_t i = 0; i < NAME_COUNT; ++i) {
+            bucketSizes[hash(NAMES[i].name, 0) % BUCKETS]++;
+        }
+
+        // largest buckets first, they're the hardest to place
+        std::array<size_t, BUCKETS> order{};
+        for (size_t i = 0; i < BUCKETS; ++i) {
+            order[i] = i;
+        }
+
+        for (size_t i = 0; i < BUCKETS; ++i) {
+            for (size_t j = i + 1; j < BUCKETS; ++j) {
+                if (bucketSizes[order[j]] > bucketSizes[order[i]]) {
+                    const auto TMP = order[i];
+                    order[i]       = order[j];
+                    order[j]       = TMP;
+                }
+            }
+        }
+
+        for (size_t b : order) {
+            if (bucketSizes[b] == 0)
+                break;
+
+            for (uint16_t seed = 1;; ++seed) {
+                if (seed == UINT16_MAX)
+                    throw "CursorShapes: no seed found, grow SLOTS";
+
+                std::array<size_t, SLOTS> taken{};
+                size_t                    takenCount = 0;
+                bool                      fits       = true;
+
+                for (size_t i = 0; i < NAME_COUNT && fits; ++i) {
+                    if (hash(NAMES[i].name, 0) % BUCKETS != b)
+                        continue;
+
+                    const size_t SLOT = hash(NAMES[i].name, seed) % SLOTS;
+
+                    if (result.slots[SLOT] != -1)
+                        fits = false;
+
+                    for (size_t t = 0; t < takenCount && fits; ++t) {
+                        if (taken[t] == SLOT)
+                            fits = false;
+                    }
+
+                    taken[takenCount++] = SLOT;
+                }
+
+                if (!fits)
+                    continue;
+
+                result.seeds[b] = seed;
+
+                for (size_t i = 0; i < NAME_COUNT; ++i) {
+                    if (hash(NAMES[i].name, 0) % BUCKETS == b)
+                        result.slots[hash(NAMES[i].name, seed) % SLOTS] = i;
+                }
+
+                break;
+            }
+        }
+
+        return result;
+    }
+
+    constexpr SPerfectHash PERFECT_HASH = buildPerfectHash();
+
+    // returns the shape a name stands for, or 0
+    constexpr uint32_t shapeFromName(std::string_view name) {
+        const auto SEED = PERFECT_HASH.seeds[hash(name, 0) % BUCKETS];
+        const auto SLOT = PERFECT_HASH.slots[hash(name, SEED) % SLOTS];
+
+        if (SLOT < 0 || NAMES[SLOT].name != name)
+            return 0;
+
+        return NAMES[SLOT].shape;
+    }
+
+    static_assert(shapeFromName("default") == 1 && shapeFromName("left_ptr") == 1 && shapeFromName("ew-resize") == 26 && shapeFromName("all-resize") == 36);
+    static_assert(shapeFromName("nonexistent") == 0 && shapeFromName("") == 0);
+}
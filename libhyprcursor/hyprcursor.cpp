@@ -1,9 +1,7 @@
 #include "hyprcursor/hyprcursor.hpp"
 #include "internalSharedTypes.hpp"
 #include "internalDefines.hpp"
-#include <array>
 #include <cstddef>
-#include <sstream>
 #include <cstdio>
 #include <filesystem>
 #include <zip.h>
@@ -11,32 +9,25 @@
 #include <algorithm>
 #include <cmath>
 #include <librsvg/rsvg.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
 
 #include "manifest.hpp"
 #include "meta.hpp"
+#include "themeIndex.hpp"
+#include "themeWatcher.hpp"
+#include "themePack.hpp"
+#include "Parallel.hpp"
+#include "resample.hpp"
 #include "Log.hpp"
 
 using namespace Hyprcursor;
 
-static std::vector<std::string> getSystemThemeDirs() {
-    const auto               envXdgData = std::getenv("XDG_DATA_DIRS");
-    std::vector<std::string> result;
-    if (envXdgData) {
-        std::stringstream envXdgStream(envXdgData);
-        std::string       tmpStr;
-        while (getline(envXdgStream, tmpStr, ':'))
-            result.push_back((tmpStr + "/icons"));
-    } else
-        result = {"/usr/share/icons"};
-
-    return result;
+// styles are kept, and shared, by their size in device pixels
+static SCursorStyleInfo deviceStyleInfo(const SCursorStyleInfo& info, float scale) {
+    return SCursorStyleInfo{.size = CHyprcursorManager::getStylePixelSize(info, scale)};
 }
 
-const std::vector<std::string>             systemThemeDirs = getSystemThemeDirs();
-constexpr const std::array<const char*, 2> userThemeDirs   = {"/.local/share/icons", "/.icons"};
-
-//
-
 static std::string themeNameFromEnv(PHYPRCURSORLOGFUNC logfn) {
     const auto ENV = getenv("HYPRCURSOR_THEME");
     if (!ENV) {
@@ -47,82 +38,19 @@ static std::string themeNameFromEnv(PHYPRCURSORLOGFUNC logfn) {
     return std::string{ENV};
 }
 
-static bool pathAccessible(const std::string& path) {
-    try {
-        if (!std::filesystem::exists(path))
-            return false;
-
-    } catch (std::exception& e) { return false; }
-
-    return true;
-}
-
-static bool themeAccessible(const std::string& path) {
-    return pathAccessible(path + "/manifest.hl") || pathAccessible(path + "/manifest.toml");
-}
-
 static std::string getFirstTheme(PHYPRCURSORLOGFUNC logfn) {
-    // try user directories first
-
     const auto HOMEENV = getenv("HOME");
     if (!HOMEENV)
         return "";
 
-    const std::string HOME{HOMEENV};
-
-    for (auto& dir : userThemeDirs) {
-        const auto FULLPATH = HOME + dir;
-        if (!pathAccessible(FULLPATH)) {
-            Debug::log(HC_LOG_TRACE, logfn, "Skipping path {} because it's inaccessible.", FULLPATH);
-            continue;
-        }
-
-        // loop over dirs and see if any has a manifest.hl
-        for (auto& themeDir : std::filesystem::directory_iterator(FULLPATH)) {
-            if (!themeDir.is_directory())
-                continue;
-
-            if (!themeAccessible(themeDir.path().string())) {
-                Debug::log(HC_LOG_TRACE, logfn, "Skipping theme {} because it's inaccessible.", themeDir.path().string());
-                continue;
-            }
-
-            const auto MANIFESTPATH = themeDir.path().string() + "/manifest.";
-
-            if (std::filesystem::exists(MANIFESTPATH + "hl") || std::filesystem::exists(MANIFESTPATH + "toml")) {
-                Debug::log(HC_LOG_INFO, logfn, "getFirstTheme: found {}", themeDir.path().string());
-                return themeDir.path().stem().string();
-            }
-        }
-    }
-
-    for (auto& dir : systemThemeDirs) {
-        const auto& FULLPATH = dir;
-        if (!pathAccessible(FULLPATH)) {
-            Debug::log(HC_LOG_TRACE, logfn, "Skipping path {} because it's inaccessible.", FULLPATH);
-            continue;
-        }
-
-        // loop over dirs and see if any has a manifest.hl
-        for (auto& themeDir : std::filesystem::directory_iterator(FULLPATH)) {
-            if (!themeDir.is_directory())
-                continue;
-
-            if (!themeAccessible(themeDir.path().string())) {
-                Debug::log(HC_LOG_TRACE, logfn, "Skipping theme {} because it's inaccessible.", themeDir.path().string());
-                continue;
-            }
-
-            const auto MANIFESTPATH = themeDir.path().string() + "/manifest.";
+    auto       index = lockThemeIndex(logfn);
+    const auto THEME = index->firstTheme();
 
-            if (std::filesystem::exists(MANIFESTPATH + "hl") || std::filesystem::exists(MANIFESTPATH + "toml")) {
-                Debug::log(HC_LOG_INFO, logfn, "getFirstTheme: found {}", themeDir.path().string());
-                return themeDir.path().stem().string();
-            }
-        }
-    }
+    if (!THEME)
+        return "";
 
-    return "";
+    Debug::log(HC_LOG_INFO, logfn, "getFirstTheme: found {}", THEME->fullPath);
+    return THEME->stem;
 }
 
 static std::string getFullPathForThemeName(const std::string& name, PHYPRCURSORLOGFUNC logfn, bool allowDefaultFallback) {
@@ -130,92 +58,63 @@ static std::string getFullPathForThemeName(const std::string& name, PHYPRCURSORL
     if (!HOMEENV)
         return "";
 
-    const std::string HOME{HOMEENV};
-
-    for (auto& dir : userThemeDirs) {
-        const auto FULLPATH = HOME + dir;
-        if (!pathAccessible(FULLPATH)) {
-            Debug::log(HC_LOG_TRACE, logfn, "Skipping path {} because it's inaccessible.", FULLPATH);
-            continue;
-        }
-
-        // loop over dirs and see if any has a manifest.hl
-        for (auto& themeDir : std::filesystem::directory_iterator(FULLPATH)) {
-            if (!themeDir.is_directory())
-                continue;
-
-            if (!themeAccessible(themeDir.path().string())) {
-                Debug::log(HC_LOG_TRACE, logfn, "Skipping theme {} because it's inaccessible.", themeDir.path().string());
-                continue;
-            }
-
-            const auto MANIFESTPATH = themeDir.path().string() + "/manifest";
-
-            if (allowDefaultFallback && name.empty()) {
-                if (std::filesystem::exists(MANIFESTPATH + ".hl") || std::filesystem::exists(MANIFESTPATH + ".toml")) {
-                    Debug::log(HC_LOG_INFO, logfn, "getFullPathForThemeName: found {}", themeDir.path().string());
-                    return std::filesystem::canonical(themeDir.path()).string();
-                }
-                continue;
-            }
-
-            CManifest manifest{MANIFESTPATH};
-            if (const auto R = manifest.parse(); R.has_value()) {
-                Debug::log(HC_LOG_ERR, logfn, "failed parsing Manifest of {}: {}", themeDir.path().string(), *R);
-                continue;
-            }
-
-            const std::string NAME = manifest.parsedData.name;
-
-            if (NAME != name && name != themeDir.path().stem().string())
-                continue;
+    {
+        auto       index = lockThemeIndex(logfn);
+        const auto THEME = name.empty() ? (allowDefaultFallback ? index->firstTheme() : nullptr) : index->findTheme(name);
 
-            Debug::log(HC_LOG_INFO, logfn, "getFullPathForThemeName: found {}", themeDir.path().string());
-            return std::filesystem::canonical(themeDir.path()).string();
+        if (THEME) {
+            Debug::log(HC_LOG_INFO, logfn, "getFullPathForThemeName: found {}", THEME->fullPath);
+            return THEME->fullPath;
         }
     }
 
-    for (auto& dir : systemThemeDirs) {
-        const auto& FULLPATH = dir;
-        if (!pathAccessible(FULLPATH)) {
-            Debug::log(HC_LOG_TRACE, logfn, "Skipping path {} because it's inaccessible.", FULLPATH);
-            continue;
-        }
+    if (allowDefaultFallback && !name.empty()) { // try without name
+        Debug::log(HC_LOG_INFO, logfn, "getFullPathForThemeName: failed, trying without name of {}", name);
+        return getFullPathForThemeName("", logfn, allowDefaultFallback);
+    }
 
-        // loop over dirs and see if any has a manifest.hl
-        for (auto& themeDir : std::filesystem::directory_iterator(FULLPATH)) {
-            if (!themeDir.is_directory())
-                continue;
+    return "";
+}
 
-            if (!themeAccessible(themeDir.path().string())) {
-                Debug::log(HC_LOG_TRACE, logfn, "Skipping theme {} because it's inaccessible.", themeDir.path().string());
-                continue;
-            }
+SThemeListC* Hyprcursor::getThemesC(PHYPRCURSORLOGFUNC fn) {
+    auto       index  = lockThemeIndex(fn);
+    const auto THEMES = index->allThemes();
 
-            const auto MANIFESTPATH = themeDir.path().string() + "/manifest";
+    Debug::log(HC_LOG_INFO, fn, "getThemesC: found {} themes", THEMES.size());
 
-            CManifest  manifest{MANIFESTPATH};
-            if (const auto R = manifest.parse(); R.has_value()) {
-                Debug::log(HC_LOG_ERR, logfn, "failed parsing Manifest of {}: {}", themeDir.path().string(), *R);
-                continue;
-            }
+    SThemeListC* list = new SThemeListC;
+    list->len         = THEMES.size();
+    list->themes      = new SThemeInfoC[list->len];
 
-            const std::string NAME = manifest.parsedData.name;
+    for (size_t i = 0; i < list->len; ++i) {
+        list->themes[i].name             = strdup(THEMES[i]->manifest.name.c_str());
+        list->themes[i].description      = strdup(THEMES[i]->manifest.description.c_str());
+        list->themes[i].version          = strdup(THEMES[i]->manifest.version.c_str());
+        list->themes[i].author           = strdup(THEMES[i]->manifest.author.c_str());
+        list->themes[i].cursorsDirectory = strdup(THEMES[i]->manifest.cursorsDirectory.c_str());
+        list->themes[i].directory        = strdup(THEMES[i]->stem.c_str());
+        list->themes[i].path             = strdup(THEMES[i]->fullPath.c_str());
+    }
 
-            if (NAME != name && name != themeDir.path().stem().string())
-                continue;
+    return list;
+}
 
-            Debug::log(HC_LOG_INFO, logfn, "getFullPathForThemeName: found {}", themeDir.path().string());
-            return std::filesystem::canonical(themeDir.path()).string();
-        }
-    }
+void Hyprcursor::freeThemesC(SThemeListC* list) {
+    if (!list)
+        return;
 
-    if (allowDefaultFallback && !name.empty()) { // try without name
-        Debug::log(HC_LOG_INFO, logfn, "getFullPathForThemeName: failed, trying without name of {}", name);
-        return getFullPathForThemeName("", logfn, allowDefaultFallback);
+    for (size_t i = 0; i < list->len; ++i) {
+        free(list->themes[i].name);
+        free(list->themes[i].description);
+        free(list->themes[i].version);
+        free(list->themes[i].author);
+        free(list->themes[i].cursorsDirectory);
+        free(list->themes[i].directory);
+        free(list->themes[i].path);
     }
 
-    return "";
+    delete[] list->themes;
+    delete list;
 }
 
 SManagerOptions::SManagerOptions() : logFn(nullptr), allowDefaultFallback(true) {
@@ -223,19 +122,41 @@ SManagerOptions::SManagerOptions() : logFn(nullptr), allowDefaultFallback(true)
 }
 
 CHyprcursorManager::CHyprcursorManager(const char* themeName_) {
+    impl = new CHyprcursorImplementation(this, logFn);
     init(themeName_);
 }
 
 CHyprcursorManager::CHyprcursorManager(const char* themeName_, PHYPRCURSORLOGFUNC fn) : logFn(fn) {
+    impl = new CHyprcursorImplementation(this, logFn);
     init(themeName_);
 }
 
 CHyprcursorManager::CHyprcursorManager(const char* themeName_, SManagerOptions options) : allowDefaultFallback(options.allowDefaultFallback), logFn(options.logFn) {
+    impl = new CHyprcursorImplementation(this, logFn);
+    init(themeName_);
+}
+
+CHyprcursorManager::CHyprcursorManager(const char* themeName_, const SManagerLoadOptions* options_) {
+    // the caller may be built against an older, shorter struct. Whatever it doesn't have stays default.
+    SManagerLoadOptions options;
+    std::memcpy(&options, options_, std::min(options_->structSize, sizeof(SManagerLoadOptions)));
+    options.structSize = sizeof(SManagerLoadOptions);
+
+    allowDefaultFallback  = options.allowDefaultFallback;
+    logFn                 = options.logFn;
+    impl                  = new CHyprcursorImplementation(this, logFn);
+    impl->lazy            = options.lazyLoading;
+    impl->loadThreads     = options.loadThreads;
+    impl->decodeOnDemand  = options.decodeOnDemand;
+    impl->lazyStyles      = options.lazyStyles;
+    impl->mipmaps         = options.mipmaps;
+    impl->svgDisplayLists = options.svgDisplayLists;
     init(themeName_);
 }
 
 void CHyprcursorManager::init(const char* themeName_) {
-    std::string themeName = themeName_ ? themeName_ : "";
+    std::string themeName    = themeName_ ? themeName_ : "";
+    impl->requestedThemeName = themeName;
 
     if (allowDefaultFallback && themeName.empty()) {
         // try reading from env
@@ -256,7 +177,6 @@ void CHyprcursorManager::init(const char* themeName_) {
     }
 
     // initialize theme
-    impl               = new CHyprcursorImplementation(this, logFn);
     impl->themeName    = themeName;
     impl->themeFullDir = getFullPathForThemeName(themeName, logFn, allowDefaultFallback);
 
@@ -277,11 +197,76 @@ void CHyprcursorManager::init(const char* themeName_) {
         return;
     }
 
+    if (impl->pack)
+        impl->shapeIndex.build(impl->theme, impl->pack);
+    else
+        impl->shapeIndex.build(impl->theme);
+    impl->buildCursorShapeHandles();
+
     finalizedAndValid = true;
 }
 
 CHyprcursorManager::~CHyprcursorManager() {
+    const int STYLELOADFD = impl->styleLoadFD;
+
+    // joins background style loads, which signal styleLoadFD
     delete impl;
+
+    if (STYLELOADFD >= 0)
+        close(STYLELOADFD);
+}
+
+int CHyprcursorManager::watchThemeChanges() {
+    if (!impl->watcher) {
+        auto watcher = std::make_unique<CThemeWatcher>(logFn);
+
+        if (!watcher->good())
+            return -1;
+
+        watcher->watch(impl->themeFullDir, impl->themeCursorsDir);
+        impl->watcher = std::move(watcher);
+    }
+
+    return impl->watcher->fd();
+}
+
+uint32_t CHyprcursorManager::dispatchThemeChanges() {
+    if (!impl->watcher)
+        return HC_THEME_CHANGE_NONE;
+
+    uint32_t changes = impl->watcher->dispatch();
+
+    // a new theme can shadow ours, or ours can become available
+    if ((changes & HC_THEME_CHANGE_INSTALLED) && !(changes & HC_THEME_CHANGE_CURRENT)) {
+        if (impl->themeFullDir.empty() || getFullPathForThemeName(impl->themeName, logFn, allowDefaultFallback) != impl->themeFullDir)
+            changes |= HC_THEME_CHANGE_CURRENT;
+    }
+
+    if (changes != HC_THEME_CHANGE_NONE)
+        Debug::log(HC_LOG_INFO, logFn, "dispatchThemeChanges: current theme {}, installed themes {}", (changes & HC_THEME_CHANGE_CURRENT) ? "changed" : "unchanged",
+                   (changes & HC_THEME_CHANGE_INSTALLED) ? "changed" : "unchanged");
+
+    return changes;
+}
+
+bool CHyprcursorManager::reloadTheme() {
+    Debug::log(HC_LOG_INFO, logFn, "reloadTheme: reloading");
+
+    const auto OLD = impl;
+    impl           = new CHyprcursorImplementation(this, logFn);
+    impl->takeManagerState(*OLD);
+
+    // joins its background style loads, the styles are gone with it
+    delete OLD;
+    finalizedAndValid = false;
+
+    const std::string THEMENAME = impl->requestedThemeName;
+    init(THEMENAME.c_str());
+
+    if (impl->watcher)
+        impl->watcher->watch(impl->themeFullDir, impl->themeCursorsDir);
+
+    return finalizedAndValid;
 }
 
 bool CHyprcursorManager::valid() {
@@ -294,87 +279,206 @@ SCursorImageData** CHyprcursorManager::getShapesC(int& outSize, const char* shap
         return nullptr;
     }
 
-    std::string                      REQUESTEDSHAPE = shape_;
+    const auto ENTRY = impl->shapeIndex.find(shape_);
+    const auto VIEW  = ENTRY ? impl->getShapeView(ENTRY->shape, info) : nullptr;
 
-    std::vector<SLoadedCursorImage*> resultingImages;
-    float                            hotX = 0, hotY = 0;
+    if (ENTRY && !VIEW)
+        return nullptr;
 
-    for (auto& shape : impl->theme.shapes) {
-        if (REQUESTEDSHAPE != shape->directory && std::find(shape->overrides.begin(), shape->overrides.end(), REQUESTEDSHAPE) == shape->overrides.end())
-            continue;
+    const size_t LEN = VIEW ? VIEW->size() : 0;
 
-        const int PIXELSIDE = std::round(info.size / shape->nominalSize);
+    // alloc and return what we need
+    SCursorImageData** data = (SCursorImageData**)malloc(sizeof(SCursorImageData*) * LEN);
+    for (size_t i = 0; i < LEN; ++i) {
+        data[i]  = (SCursorImageData*)malloc(sizeof(SCursorImageData));
+        *data[i] = VIEW->at(i);
+    }
 
-        hotX = shape->hotspotX;
-        hotY = shape->hotspotY;
+    outSize = LEN;
 
-        // matched :)
-        bool foundAny = false;
-        for (auto& image : impl->loadedShapes[shape.get()].images) {
-            if (image->side != PIXELSIDE)
-                continue;
+    Debug::log(HC_LOG_INFO, logFn, "getShapesC: found {} images for {}", outSize, shape_);
 
-            // found size
-            resultingImages.push_back(image.get());
-            foundAny = true;
-        }
+    return data;
+}
 
-        if (foundAny || shape->shapeType == SHAPE_SVG /* something broke, this shouldn't happen with svg */)
-            break;
+SCursorImageDataViewC CHyprcursorManager::getShapeViewC(const char* shape_, const SCursorStyleInfo& info) {
+    if (!shape_ || !impl)
+        return {nullptr, 0};
 
-        // if we get here, means loadThemeStyle wasn't called most likely. If resize algo is specified, this is an error.
-        if (shape->resizeAlgo != HC_RESIZE_NONE) {
-            Debug::log(HC_LOG_ERR, logFn, "getSurfaceFor didn't match a size?");
-            return nullptr;
-        }
+    const auto ENTRY = impl->shapeIndex.find(shape_);
+    const auto VIEW  = ENTRY ? impl->getShapeView(ENTRY->shape, info) : nullptr;
 
-        // find nearest
-        int leader = 13371337;
-        for (auto& image : impl->loadedShapes[shape.get()].images) {
-            if (std::abs((int)(image->side - PIXELSIDE)) > std::abs((int)(leader - PIXELSIDE)))
-                continue;
+    if (!VIEW)
+        return {nullptr, 0};
 
-            leader = image->side;
-        }
+    return {VIEW->data(), VIEW->size()};
+}
 
-        if (leader == 13371337) { // ???
-            Debug::log(HC_LOG_ERR, logFn, "getSurfaceFor didn't match any nearest size?");
-            return nullptr;
-        }
+unsigned int CHyprcursorManager::getShapeHandle(const char* shape_) {
+    if (!shape_ || !impl)
+        return 0;
 
-        // we found nearest size
-        for (auto& image : impl->loadedShapes[shape.get()].images) {
-            if (image->side != leader)
-                continue;
+    if (const auto ENTRY = impl->shapeIndex.find(shape_); ENTRY)
+        return ENTRY->handle;
 
-            // found size
-            resultingImages.push_back(image.get());
-            foundAny = true;
-        }
+    // the theme might have the same shape under another known name
+    return getCursorShapeV1Handle(CursorShapes::shapeFromName(shape_));
+}
 
-        if (foundAny)
-            break;
+unsigned int CHyprcursorManager::getCursorShapeV1Handle(uint32_t shape) {
+    if (!impl || shape >= impl->cursorShapeHandles.size())
+        return 0;
+
+    return impl->cursorShapeHandles[shape];
+}
+
+SCursorImageDataViewC CHyprcursorManager::getShapeViewForHandleC(unsigned int handle, const SCursorStyleInfo& info) {
+    if (!impl || handle == 0 || handle > impl->theme.shapes.size())
+        return {nullptr, 0};
+
+    const auto VIEW = impl->getShapeView(impl->theme.shapes[handle - 1].get(), info);
+
+    if (!VIEW)
+        return {nullptr, 0};
+
+    return {VIEW->data(), VIEW->size()};
+}
+
+/*
+    Packs the views into one allocation:
+    the batch struct, then one view per shape, then all images.
+*/
+static SCursorImageDataBatchC* makeBatch(const std::vector<const std::vector<SCursorImageData>*>& views) {
+    size_t images = 0;
+    for (auto& v : views) {
+        images += v ? v->size() : 0;
+    }
 
-        Debug::log(HC_LOG_ERR, logFn, "getSurfaceFor didn't match any nearest size (2)?");
+    static_assert(alignof(SCursorImageDataViewC) <= alignof(SCursorImageDataBatchC) && alignof(SCursorImageData) <= alignof(SCursorImageDataViewC));
+
+    const size_t VIEWSOFFSET  = sizeof(SCursorImageDataBatchC);
+    const size_t IMAGESOFFSET = VIEWSOFFSET + sizeof(SCursorImageDataViewC) * views.size();
+
+    auto         block = (uint8_t*)malloc(IMAGESOFFSET + sizeof(SCursorImageData) * images);
+    if (!block)
         return nullptr;
+
+    auto batch    = (SCursorImageDataBatchC*)block;
+    batch->shapes = (SCursorImageDataViewC*)(block + VIEWSOFFSET);
+    batch->len    = views.size();
+
+    auto imageOut = (SCursorImageData*)(block + IMAGESOFFSET);
+
+    for (size_t i = 0; i < views.size(); ++i) {
+        const size_t LEN = views[i] ? views[i]->size() : 0;
+
+        if (LEN > 0)
+            std::memcpy(imageOut, views[i]->data(), sizeof(SCursorImageData) * LEN);
+
+        batch->shapes[i] = {LEN > 0 ? imageOut : nullptr, LEN};
+        imageOut += LEN;
     }
 
-    // alloc and return what we need
-    SCursorImageData** data = (SCursorImageData**)malloc(sizeof(SCursorImageData*) * resultingImages.size());
-    for (size_t i = 0; i < resultingImages.size(); ++i) {
-        data[i]           = (SCursorImageData*)malloc(sizeof(SCursorImageData));
-        data[i]->delay    = resultingImages[i]->delay;
-        data[i]->size     = resultingImages[i]->side;
-        data[i]->surface  = resultingImages[i]->cairoSurface;
-        data[i]->hotspotX = std::round(hotX * (float)data[i]->size);
-        data[i]->hotspotY = std::round(hotY * (float)data[i]->size);
+    return batch;
+}
+
+SCursorImageDataViewC CHyprcursorManager::getStyleShapeViewC(SCursorStyleC* style, const char* shape_) {
+    if (!impl || !style || !shape_)
+        return {nullptr, 0};
+
+    const auto ENTRY = impl->shapeIndex.find(shape_);
+    const auto VIEW  = ENTRY ? impl->getStyleShapeView(style, ENTRY->shape) : nullptr;
+
+    if (!VIEW)
+        return {nullptr, 0};
+
+    return {VIEW->data(), VIEW->size()};
+}
+
+SCursorImageDataViewC CHyprcursorManager::getStyleShapeViewForHandleC(SCursorStyleC* style, unsigned int handle) {
+    if (!impl || !style || handle == 0 || handle > impl->theme.shapes.size())
+        return {nullptr, 0};
+
+    const auto VIEW = impl->getStyleShapeView(style, impl->theme.shapes[handle - 1].get());
+
+    if (!VIEW)
+        return {nullptr, 0};
+
+    return {VIEW->data(), VIEW->size()};
+}
+
+SCursorImageDataBatchC* CHyprcursorManager::getShapesBatchC(const char* const* shapes, size_t len, const SCursorStyleInfo& info) {
+    if (!impl || (!shapes && len > 0))
+        return nullptr;
+
+    std::vector<const std::vector<SCursorImageData>*> views(len, nullptr);
+
+    for (size_t i = 0; i < len; ++i) {
+        if (!shapes[i])
+            continue;
+
+        if (const auto ENTRY = impl->shapeIndex.find(shapes[i]); ENTRY)
+            views[i] = impl->getShapeView(ENTRY->shape, info);
     }
 
-    outSize = resultingImages.size();
+    Debug::log(HC_LOG_INFO, logFn, "getShapesBatchC: resolved {} shapes at size {}", len, info.size);
 
-    Debug::log(HC_LOG_INFO, logFn, "getShapesC: found {} images for {}", outSize, shape_);
+    return makeBatch(views);
+}
 
-    return data;
+SCursorImageDataBatchC* CHyprcursorManager::getShapesBatchForHandlesC(const unsigned int* handles, size_t len, const SCursorStyleInfo& info) {
+    if (!impl || (!handles && len > 0))
+        return nullptr;
+
+    std::vector<const std::vector<SCursorImageData>*> views(len, nullptr);
+
+    for (size_t i = 0; i < len; ++i) {
+        if (handles[i] == 0 || handles[i] > impl->theme.shapes.size())
+            continue;
+
+        views[i] = impl->getShapeView(impl->theme.shapes[handles[i] - 1].get(), info);
+    }
+
+    Debug::log(HC_LOG_INFO, logFn, "getShapesBatchForHandlesC: resolved {} shapes at size {}", len, info.size);
+
+    return makeBatch(views);
+}
+
+SCursorRawShapeDataView CHyprcursorManager::getRawShapeDataView(const char* shape_) {
+    if (!shape_ || !impl)
+        return {};
+
+    const auto ENTRY = impl->shapeIndex.find(shape_);
+    if (!ENTRY)
+        return {};
+
+    // same as following overridenBy from getRawShapeData
+    const auto shape = ENTRY->overriddenBy ? ENTRY->overriddenBy : ENTRY->owner;
+    if (!shape)
+        return {};
+
+    auto&                               views = impl->rawViews[shape];
+    std::unique_lock<std::shared_mutex> lock(impl->loadedShapes.at(shape).mutex);
+
+    if (views.empty() && impl->ensureShapeLoaded(shape)) {
+        for (auto& image : impl->loadedShapes.at(shape).images) {
+            // made by loadThemeStyle, no raw data
+            if (image->artificial || !image->data)
+                continue;
+
+            views.push_back(SCursorRawShapeImageView{.data = {(const std::byte*)image->data, image->dataLen}, .size = image->side, .delay = image->delay});
+        }
+    }
+
+    return SCursorRawShapeDataView{
+        .images      = views,
+        .shape       = shape->directory,
+        .hotspotX    = shape->hotspotX,
+        .hotspotY    = shape->hotspotY,
+        .nominalSize = shape->nominalSize,
+        .resizeAlgo  = shape->resizeAlgo,
+        .type        = shape->shapeType == SHAPE_PNG ? HC_DATA_PNG : HC_DATA_SVG,
+    };
 }
 
 SCursorRawShapeDataC* CHyprcursorManager::getRawShapeDataC(const char* shape_) {
@@ -396,24 +500,22 @@ SCursorRawShapeDataC* CHyprcursorManager::getRawShapeDataC(const char* shape_) {
     data->resizeAlgo  = eHyprcursorResizeAlgo::HC_RESIZE_NONE;
     data->type        = eHyprcursorDataType::HC_DATA_PNG;
 
-    for (auto& shape : impl->theme.shapes) {
-        // if it's overridden just return the override
-        if (const auto IT = std::find_if(shape->overrides.begin(), shape->overrides.end(), [&](const auto& e) { return e == SHAPE && SHAPE != shape->directory; });
-            IT != shape->overrides.end()) {
-            data->overridenBy = strdup(shape->directory.c_str());
-            return data;
-        }
+    const auto ENTRY = impl->shapeIndex.find(SHAPE);
+
+    // if it's overridden just return the override
+    if (ENTRY && ENTRY->overriddenBy) {
+        data->overridenBy = strdup(ENTRY->overriddenBy->directory.c_str());
+        return data;
     }
 
-    for (auto& shape : impl->theme.shapes) {
-        if (shape->directory != SHAPE)
-            continue;
+    if (ENTRY && ENTRY->owner && impl->loadedShapes.contains(ENTRY->owner)) {
+        const auto                          shape = ENTRY->owner;
+        std::unique_lock<std::shared_mutex> lock(impl->loadedShapes.at(shape).mutex);
 
-        if (!impl->loadedShapes.contains(shape.get()))
-            continue; // ??
+        impl->ensureShapeLoaded(shape);
 
         // found it
-        for (auto& i : impl->loadedShapes[shape.get()].images) {
+        for (auto& i : impl->loadedShapes.at(shape).images) {
             resultingImages.push_back(i.get());
         }
 
@@ -421,7 +523,6 @@ SCursorRawShapeDataC* CHyprcursorManager::getRawShapeDataC(const char* shape_) {
         data->hotspotY    = shape->hotspotY;
         data->nominalSize = shape->nominalSize;
         data->type        = shape->shapeType == SHAPE_PNG ? HC_DATA_PNG : HC_DATA_SVG;
-        break;
     }
 
     data->len    = resultingImages.size();
@@ -438,178 +539,309 @@ SCursorRawShapeDataC* CHyprcursorManager::getRawShapeDataC(const char* shape_) {
 }
 
 bool CHyprcursorManager::loadThemeStyle(const SCursorStyleInfo& info) {
-    Debug::log(HC_LOG_INFO, logFn, "loadThemeStyle: loading for size {}", info.size);
-
-    for (auto& shape : impl->theme.shapes) {
-        if (shape->resizeAlgo == HC_RESIZE_NONE && shape->shapeType != SHAPE_SVG) {
-            // don't resample NONE style cursors
-            Debug::log(HC_LOG_TRACE, logFn, "loadThemeStyle: ignoring {}", shape->directory);
-            continue;
-        }
+    return acquireStyle(info) != nullptr;
+}
 
-        bool sizeFound = false;
+SCursorStyleC* CHyprcursorManager::acquireStyle(const SCursorStyleInfo& info_, float scale) {
+    const auto info = deviceStyleInfo(info_, scale);
 
-        if (shape->shapeType == SHAPE_PNG) {
-            const int IDEALSIDE = std::round(info.size / shape->nominalSize);
+    if (!impl)
+        return nullptr;
 
-            for (auto& image : impl->loadedShapes[shape.get()].images) {
-                if (image->side != IDEALSIDE)
-                    continue;
+    if (const auto IT = impl->styles.find(info.size); IT != impl->styles.end()) {
+        IT->second->refs++;
+        Debug::log(HC_LOG_TRACE, logFn, "loadThemeStyle: size {} already loaded, {} refs", info.size, IT->second->refs);
 
-                sizeFound = true;
-                break;
-            }
+        // the caller expects it done when we return
+        if (IT->second->loading)
+            impl->finishStyleLoads(IT->second.get());
 
-            // size wasn't found, let's resample.
-            if (sizeFound)
-                continue;
+        return IT->second.get();
+    }
 
-            SLoadedCursorImage* leader    = nullptr;
-            int                 leaderVal = 1000000;
-            for (auto& image : impl->loadedShapes[shape.get()].images) {
-                if (image->side < IDEALSIDE)
-                    continue;
+    Debug::log(HC_LOG_INFO, logFn, "loadThemeStyle: loading for size {}", info.size);
 
-                if (image->side > leaderVal)
-                    continue;
+    auto style  = std::make_unique<SCursorStyleC>();
+    style->info = info;
+    style->refs = 1;
 
-                leaderVal = image->side;
-                leader    = image.get();
-            }
+    if (!impl->lazyStyles) {
+        std::vector<SCursorShape*> shapes;
+        shapes.reserve(impl->theme.shapes.size());
 
-            if (!leader) {
-                for (auto& image : impl->loadedShapes[shape.get()].images) {
-                    if (std::abs((int)(image->side - IDEALSIDE)) > leaderVal)
-                        continue;
+        for (auto& shape : impl->theme.shapes) {
+            shapes.emplace_back(shape.get());
+        }
 
-                    leaderVal = image->side;
-                    leader    = image.get();
-                }
-            }
+        if (const auto RET = impl->renderStyleShapes(style.get(), shapes); RET.has_value()) {
+            Debug::log(HC_LOG_ERR, logFn, "loadThemeStyle: {}", RET.value());
+            return nullptr;
+        }
+    }
 
-            if (!leader) {
-                Debug::log(HC_LOG_ERR, logFn, "Resampling failed to find a candidate???");
-                return false;
-            }
+    // views made before this might have picked a nearest size
+    impl->dropShapeViews(info.size);
 
-            const auto FRAMES = impl->getFramesFor(shape.get(), leader->side);
+    return impl->styles.emplace(info.size, std::move(style)).first->second.get();
+}
 
-            Debug::log(HC_LOG_TRACE, logFn, "loadThemeStyle: png shape {} has {} frames", shape->directory, FRAMES.size());
+unsigned int CHyprcursorManager::getStylePixelSize(const SCursorStyleInfo& info, float scale) {
+    return (unsigned int)(info.size * (scale > 0.F ? scale : 1.F) + 0.5F);
+}
 
-            const int PIXELSIDE = std::round(info.size / shape->nominalSize);
+SCursorStyleInfo CHyprcursorManager::getStyleInfo(SCursorStyleC* style) {
+    if (!style)
+        return {};
 
-            Debug::log(HC_LOG_TRACE, logFn, "loadThemeStyle: png shape has nominal {:.2f}, pixel size will be {}x", shape->nominalSize, PIXELSIDE);
+    return style->info;
+}
 
-            for (auto& f : FRAMES) {
-                auto& newImage           = impl->loadedShapes[shape.get()].images.emplace_back(std::make_unique<SLoadedCursorImage>());
-                newImage->artificial     = true;
-                newImage->side           = PIXELSIDE;
-                newImage->artificialData = new char[static_cast<unsigned long>(PIXELSIDE * PIXELSIDE * 4)];
-                newImage->cairoSurface   = cairo_image_surface_create_for_data((unsigned char*)newImage->artificialData, CAIRO_FORMAT_ARGB32, PIXELSIDE, PIXELSIDE, PIXELSIDE * 4);
-                newImage->delay          = f->delay;
+void CHyprcursorManager::releaseStyle(SCursorStyleC* style) {
+    if (!impl || !style)
+        return;
 
-                const auto PCAIRO = cairo_create(newImage->cairoSurface);
+    if (--style->refs > 0)
+        return;
 
-                cairo_set_antialias(PCAIRO, shape->resizeAlgo == HC_RESIZE_BILINEAR ? CAIRO_ANTIALIAS_GOOD : CAIRO_ANTIALIAS_NONE);
+    Debug::log(HC_LOG_INFO, logFn, "releaseStyle: freeing style for size {}", style->info.size);
 
-                cairo_save(PCAIRO);
-                cairo_set_operator(PCAIRO, CAIRO_OPERATOR_CLEAR);
-                cairo_paint(PCAIRO);
-                cairo_restore(PCAIRO);
+    const auto SIZE = style->info.size;
 
-                const auto PTN = cairo_pattern_create_for_surface(f->cairoSurface);
-                cairo_pattern_set_extend(PTN, CAIRO_EXTEND_NONE);
-                const float scale = PIXELSIDE / (float)f->side;
-                cairo_scale(PCAIRO, scale, scale);
-                cairo_pattern_set_filter(PTN, shape->resizeAlgo == HC_RESIZE_BILINEAR ? CAIRO_FILTER_GOOD : CAIRO_FILTER_NEAREST);
-                cairo_set_source(PCAIRO, PTN);
+    if (style->loading)
+        impl->cancelStyleLoad(style);
 
-                cairo_rectangle(PCAIRO, 0, 0, PIXELSIDE, PIXELSIDE);
+    // styles still loading can be borrowing its frames, they keep them alive until their own are in
+    impl->styles.erase(SIZE);
+    impl->dropShapeViews(SIZE);
+}
 
-                cairo_fill(PCAIRO);
-                cairo_surface_flush(newImage->cairoSurface);
+void CHyprcursorManager::cursorSurfaceStyleDone(const SCursorStyleInfo& info) {
+    if (!impl)
+        return;
 
-                cairo_pattern_destroy(PTN);
-                cairo_destroy(PCAIRO);
-            }
-        } else if (shape->shapeType == SHAPE_SVG) {
-            const auto FRAMES = impl->getFramesFor(shape.get(), 0);
+    if (const auto IT = impl->styles.find(info.size); IT != impl->styles.end())
+        releaseStyle(IT->second.get());
+}
 
-            Debug::log(HC_LOG_TRACE, logFn, "loadThemeStyle: svg shape {} has {} frames", shape->directory, FRAMES.size());
+SCursorStyleC* CHyprcursorManager::acquireStyleAsync(const SCursorStyleInfo& info_, float scale) {
+    const auto info = deviceStyleInfo(info_, scale);
 
-            const int PIXELSIDE = std::round(info.size / shape->nominalSize);
+    if (!impl)
+        return nullptr;
 
-            Debug::log(HC_LOG_TRACE, logFn, "loadThemeStyle: svg shape has nominal {:.2f}, pixel size will be {}x", shape->nominalSize, PIXELSIDE);
+    if (const auto IT = impl->styles.find(info.size); IT != impl->styles.end()) {
+        IT->second->refs++;
+        Debug::log(HC_LOG_TRACE, logFn, "acquireStyleAsync: size {} already {}, {} refs", info.size, IT->second->loading ? "loading" : "loaded", IT->second->refs);
+        return IT->second.get();
+    }
 
-            for (auto& f : FRAMES) {
-                auto& newImage           = impl->loadedShapes[shape.get()].images.emplace_back(std::make_unique<SLoadedCursorImage>());
-                newImage->artificial     = true;
-                newImage->side           = PIXELSIDE;
-                newImage->artificialData = new char[static_cast<unsigned long>(PIXELSIDE * PIXELSIDE * 4)];
-                newImage->cairoSurface   = cairo_image_surface_create_for_data((unsigned char*)newImage->artificialData, CAIRO_FORMAT_ARGB32, PIXELSIDE, PIXELSIDE, PIXELSIDE * 4);
-                newImage->delay          = f->delay;
+    if (watchStyleLoads() < 0)
+        return nullptr;
 
-                const auto PCAIRO = cairo_create(newImage->cairoSurface);
+    Debug::log(HC_LOG_INFO, logFn, "acquireStyleAsync: loading for size {}", info.size);
 
-                cairo_save(PCAIRO);
-                cairo_set_operator(PCAIRO, CAIRO_OPERATOR_CLEAR);
-                cairo_paint(PCAIRO);
-                cairo_restore(PCAIRO);
+    auto style  = std::make_unique<SCursorStyleC>();
+    style->info = info;
+    style->refs = 1;
 
-                GError*     error  = nullptr;
-                RsvgHandle* handle = rsvg_handle_new_from_data((unsigned char*)f->data, f->dataLen, &error);
+    if (const auto RET = impl->startStyleLoad(style.get()); RET.has_value()) {
+        Debug::log(HC_LOG_ERR, logFn, "acquireStyleAsync: {}", RET.value());
+        return nullptr;
+    }
 
-                if (!handle) {
-                    Debug::log(HC_LOG_ERR, logFn, "Failed reading svg: {}", error->message);
-                    return false;
-                }
+    impl->dropShapeViews(info.size);
 
-                RsvgRectangle rect = {0, 0, (double)PIXELSIDE, (double)PIXELSIDE};
+    return impl->styles.emplace(info.size, std::move(style)).first->second.get();
+}
 
-                if (!rsvg_handle_render_document(handle, PCAIRO, &rect, &error)) {
-                    Debug::log(HC_LOG_ERR, logFn, "Failed rendering svg: {}", error->message);
-                    g_object_unref(handle);
-                    return false;
-                }
+int CHyprcursorManager::watchStyleLoads() {
+    if (impl->styleLoadFD < 0) {
+        impl->styleLoadFD = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
 
-                // done
-                cairo_surface_flush(newImage->cairoSurface);
-                cairo_destroy(PCAIRO);
-                g_object_unref(handle);
-            }
-        } else {
-            Debug::log(HC_LOG_ERR, logFn, "Invalid shapetype in loadThemeStyle");
-            return false;
+        if (impl->styleLoadFD < 0) {
+            Debug::log(HC_LOG_ERR, logFn, "watchStyleLoads: eventfd failed: {}", strerror(errno));
+            return -1;
         }
     }
 
-    return true;
+    return impl->styleLoadFD;
 }
 
-void CHyprcursorManager::cursorSurfaceStyleDone(const SCursorStyleInfo& info) {
-    for (auto& shape : impl->theme.shapes) {
-        if (shape->resizeAlgo == HC_RESIZE_NONE && shape->shapeType != SHAPE_SVG)
-            continue;
+unsigned int CHyprcursorManager::dispatchStyleLoads() {
+    if (!impl)
+        return 0;
 
-        std::erase_if(impl->loadedShapes[shape.get()].images, [info, &shape](const auto& e) {
-            const bool isSVG        = shape->shapeType == SHAPE_SVG;
-            const bool isArtificial = e->artificial;
+    if (impl->styleLoadFD >= 0) {
+        eventfd_t value = 0;
+        eventfd_read(impl->styleLoadFD, &value);
+    }
 
-            // clean artificial rasters made for this
-            if (isArtificial && e->side == std::round(info.size / shape->nominalSize))
-                return true;
+    return impl->dispatchStyleLoads();
+}
 
-            // clean invalid non-svg rasters
-            if (!isSVG && e->side == 0)
-                return true;
+bool CHyprcursorManager::styleLoading(SCursorStyleC* style) {
+    return style && style->loading;
+}
 
-            return false;
-        });
+void CHyprcursorManager::trimDecodedSurfaces() {
+    if (!impl)
+        return;
+
+    // background loads read the surfaces we're about to free
+    impl->finishStyleLoads();
+
+    // views of loaded styles stay valid, so whatever they point at stays decoded. That's native sizes,
+    // NONE shapes, and the fallbacks of loading styles.
+    std::unordered_set<cairo_surface_t*> inUse;
+    for (auto& [size, style] : impl->styles) {
+        for (auto& [shape, view] : style->views) {
+            for (auto& image : view) {
+                inUse.emplace(image.surface);
+            }
+        }
+    }
+
+    // views without a style are documented to be invalidated
+    impl->shapeViews.clear();
+
+    size_t trimmed = 0;
+
+    for (auto& [shape, loadedShape] : impl->loadedShapes) {
+        for (auto& image : loadedShape.images) {
+            // artificial images belong to styles, and svgs have nothing decoded
+            if (image->artificial || image->isSVG || !image->cairoSurface || !image->data || inUse.contains(image->cairoSurface))
+                continue;
+
+            cairo_surface_destroy(image->cairoSurface);
+            image->cairoSurface = nullptr;
+            trimmed++;
+        }
+    }
+
+    // parsed and recorded svgs can be parsed again
+    for (auto& [shape, loadedShape] : impl->loadedShapes) {
+        for (auto& image : loadedShape.images) {
+            if (image->svgHandle) {
+                g_object_unref(image->svgHandle);
+                image->svgHandle = nullptr;
+                trimmed++;
+            }
+
+            if (image->svgRecording) {
+                cairo_surface_destroy(image->svgRecording);
+                image->svgRecording = nullptr;
+                trimmed++;
+            }
+        }
+    }
+
+    // mip levels are made from the decoded surfaces
+    for (auto& [shape, loadedShape] : impl->loadedShapes) {
+        for (auto& level : loadedShape.mips) {
+            trimmed += level.size();
+        }
+
+        loadedShape.mips.clear();
     }
+
+    Debug::log(HC_LOG_INFO, logFn, "trimDecodedSurfaces: freed {} surfaces and documents", trimmed);
 }
 
 void CHyprcursorManager::registerLoggingFunction(PHYPRCURSORLOGFUNC fn) {
     logFn = fn;
+
+    if (impl)
+        impl->logFn = fn;
+}
+
+/*
+
+Archive reading
+
+*/
+
+constexpr size_t ZIP_READ_CHUNK   = 64 * 1024;
+constexpr size_t ZIP_SCRATCH_KEEP = 1024 * 1024;
+
+// archives are read on several threads at once, each gets its own scratch buffer
+static std::vector<char>& zipScratch() {
+    static thread_local std::vector<char> scratch;
+    return scratch;
+}
+
+// keeps the buffer for the next entry, unless a large one blew it up
+static void releaseZipScratch(std::vector<char>& scratch) {
+    if (scratch.capacity() > ZIP_SCRATCH_KEEP) {
+        scratch.clear();
+        scratch.shrink_to_fit();
+    }
+}
+
+static std::optional<zip_uint64_t> zipEntrySize(zip_t* zip, zip_int64_t index) {
+    zip_stat_t sb;
+    zip_stat_init(&sb);
+
+    if (zip_stat_index(zip, index, ZIP_FL_UNCHANGED, &sb) != 0 || !(sb.valid & ZIP_STAT_SIZE))
+        return std::nullopt;
+
+    return sb.size;
+}
+
+// reads up to len bytes, returns the amount read or -1
+static zip_int64_t readZipFile(zip_file_t* file, char* out, size_t len) {
+    size_t done = 0;
+
+    while (done < len) {
+        const auto READ = zip_fread(file, out + done, len - done);
+
+        if (READ < 0)
+            return -1;
+
+        if (READ == 0)
+            break;
+
+        done += READ;
+    }
+
+    return done;
+}
+
+/*
+    Reads a whole entry into out, sized from the central directory.
+    Entries without a size, or larger than they claimed, are streamed in chunks.
+    Returns the amount of bytes read, or -1.
+*/
+static zip_int64_t readZipEntry(zip_t* zip, zip_int64_t index, std::vector<char>& out) {
+    zip_file_t* file = zip_fopen_index(zip, index, ZIP_FL_UNCHANGED);
+    if (!file)
+        return -1;
+
+    // one byte over the size, so that hitting EOF doesn't need another chunk
+    const auto SIZE = zipEntrySize(zip, index);
+    out.resize(SIZE.has_value() ? *SIZE + 1 : ZIP_READ_CHUNK);
+
+    size_t done = 0;
+
+    while (true) {
+        if (done == out.size())
+            out.resize(out.size() + ZIP_READ_CHUNK);
+
+        const auto READ = readZipFile(file, out.data() + done, out.size() - done);
+
+        if (READ < 0) {
+            zip_fclose(file);
+            return -1;
+        }
+
+        done += READ;
+
+        if (done < out.size())
+            break;
+    }
+
+    zip_fclose(file);
+
+    return done;
 }
 
 /*
@@ -656,148 +888,1224 @@ std::optional<std::string> CHyprcursorImplementation::loadTheme() {
     const std::string CURSORSSUBDIR = manifest.parsedData.cursorsDirectory;
     const std::string CURSORDIR     = themeFullDir + "/" + CURSORSSUBDIR;
 
-    if (CURSORSSUBDIR.empty() || !std::filesystem::exists(CURSORDIR))
+    if (CURSORSSUBDIR.empty())
         return "loadTheme: cursors_directory missing or empty";
 
+    // a pack has everything in one file, prefer it over the archives unless they changed since it was written
+    if (const auto PACKPATH = CURSORDIR + ".hcpack"; std::filesystem::exists(PACKPATH)) {
+        const bool HASDIR = std::filesystem::exists(CURSORDIR);
+
+        if (loadThemePack(PACKPATH, HASDIR ? CThemePack::sourceStamp(CURSORDIR) : 0)) {
+            themeCursorsDir = HASDIR ? CURSORDIR : "";
+            return {};
+        }
+
+        if (HASDIR)
+            Debug::log(HC_LOG_WARN, logFn, "loadTheme: pack {} can't be used, loading the cursors directory instead", PACKPATH);
+    }
+
+    if (!std::filesystem::exists(CURSORDIR))
+        return "loadTheme: cursors_directory missing or empty";
+
+    themeCursorsDir = CURSORDIR;
+
+    std::vector<std::filesystem::path> archives;
     for (auto& cursor : std::filesystem::directory_iterator(CURSORDIR)) {
         if (!cursor.is_regular_file()) {
             Debug::log(HC_LOG_TRACE, logFn, "loadTheme: skipping {}", cursor.path().string());
             continue;
         }
 
+        archives.push_back(cursor.path());
+    }
+
+    // keep the shape order independent of the fs and of which worker finishes first
+    std::sort(archives.begin(), archives.end());
+
+    std::vector<SLoadedCursorShape*> loaded;
+    for (auto& path : archives) {
         auto& SHAPE       = theme.shapes.emplace_back(std::make_unique<SCursorShape>());
         auto& LOADEDSHAPE = loadedShapes[SHAPE.get()];
 
-        // extract zip to raw data.
-        int         errp = 0;
-        zip_t*      zip  = zip_open(cursor.path().string().c_str(), ZIP_RDONLY, &errp);
+        LOADEDSHAPE.archivePath = path.string();
+        loaded.push_back(&LOADEDSHAPE);
+    }
+
+    // every archive is independent, and slots are set up beforehand, so workers share nothing
+    std::vector<std::optional<std::string>> results(archives.size());
 
-        zip_int64_t index    = zip_name_locate(zip, "meta.hl", ZIP_FL_ENC_GUESS);
-        bool        metaIsHL = true;
+    Parallel::forEach(archives.size(), std::max(loadThreads, 1U), [&](size_t i) { results[i] = loadShapeArchive(archives[i], theme.shapes[i].get(), *loaded[i]); });
 
-        if (index == -1) {
-            index    = zip_name_locate(zip, "meta.toml", ZIP_FL_ENC_GUESS);
-            metaIsHL = false;
-        }
+    for (auto& r : results) {
+        if (r.has_value())
+            return r;
+    }
 
-        if (index == -1)
-            return "cursor" + cursor.path().string() + "failed to load meta";
+    return {};
+}
 
-        zip_file_t* meta_file = zip_fopen_index(zip, index, ZIP_FL_UNCHANGED);
+bool CHyprcursorImplementation::loadThemePack(const std::string& path, uint64_t stamp) {
+    auto themePack = std::make_shared<CThemePack>(path);
 
-        char*       buffer = new char[static_cast<unsigned long>(1024 * 1024)]; /* 1MB should be more than enough */
+    if (!themePack->good()) {
+        Debug::log(HC_LOG_ERR, logFn, "loadThemePack: {} is not a valid pack", path);
+        return false;
+    }
 
-        int         readBytes = zip_fread(meta_file, buffer, (1024 * 1024) - 1);
+    if (stamp && themePack->sourceStamp() != stamp) {
+        Debug::log(HC_LOG_WARN, logFn, "loadThemePack: {} is out of date, the cursors directory changed since it was written", path);
+        return false;
+    }
 
-        zip_fclose(meta_file);
+    // only the shapes' metadata is read here. Their frames are read from the mapping on first use, see ensureShapeLoaded,
+    // and names are looked up in the pack's table, so nothing else needs to be walked.
+    const auto RESULT = [&]() -> std::optional<std::string> {
+        for (uint32_t i = 0; i < themePack->shapeCount(); ++i) {
+            const auto PACKSHAPE = themePack->shape(i);
+            const auto NAME      = themePack->string(PACKSHAPE->name, PACKSHAPE->nameLen);
 
-        if (readBytes < 0) {
-            delete[] buffer;
-            return "cursor" + cursor.path().string() + "failed to read meta";
-        }
+            if (NAME.empty())
+                return "shape " + std::to_string(i) + " has no name";
 
-        buffer[readBytes] = '\0';
+            if (PACKSHAPE->shapeType != SHAPE_PNG && PACKSHAPE->shapeType != SHAPE_SVG)
+                return "shape " + std::string{NAME} + " has an invalid type";
 
-        CMeta meta{buffer, metaIsHL};
+            if (PACKSHAPE->resizeAlgo <= HC_RESIZE_INVALID || PACKSHAPE->resizeAlgo > HC_RESIZE_LANCZOS)
+                return "shape " + std::string{NAME} + " has an invalid resize algorithm";
 
-        delete[] buffer;
+            if (PACKSHAPE->frameCount == 0)
+                return "shape " + std::string{NAME} + " has no images";
 
-        const auto METAPARSERESULT = meta.parse();
-        if (METAPARSERESULT.has_value())
-            return "cursor" + cursor.path().string() + "failed to parse meta: " + *METAPARSERESULT;
+            auto& shape        = theme.shapes.emplace_back(std::make_unique<SCursorShape>());
+            shape->directory   = NAME;
+            shape->hotspotX    = PACKSHAPE->hotspotX;
+            shape->hotspotY    = PACKSHAPE->hotspotY;
+            shape->nominalSize = PACKSHAPE->nominalSize;
+            shape->resizeAlgo  = (eHyprcursorResizeAlgo)PACKSHAPE->resizeAlgo;
+            shape->shapeType   = (eShapeType)PACKSHAPE->shapeType;
 
-        for (auto& i : meta.parsedData.definedSizes) {
-            SHAPE->images.push_back(SCursorImage{.filename = i.file, .size = i.size, .delay = i.delayMs});
+            auto& loadedShape       = loadedShapes[shape.get()];
+            loadedShape.archivePath = path;
+            loadedShape.packShape   = i;
         }
 
-        SHAPE->overrides = meta.parsedData.overrides;
+        return {};
+    }();
 
-        zip_stat_t sb;
-        zip_stat_init(&sb);
+    if (RESULT.has_value()) {
+        Debug::log(HC_LOG_ERR, logFn, "loadThemePack: {}: {}", path, *RESULT);
+        loadedShapes.clear();
+        theme.shapes.clear();
+        return false;
+    }
 
-        for (auto& i : SHAPE->images) {
-            if (SHAPE->shapeType == SHAPE_INVALID) {
-                if (i.filename.ends_with(".svg"))
-                    SHAPE->shapeType = SHAPE_SVG;
-                else if (i.filename.ends_with(".png"))
-                    SHAPE->shapeType = SHAPE_PNG;
-                else {
-                    Debug::log(HC_LOG_WARN, logFn, "WARNING: image {} has no known extension, assuming png.", i.filename);
-                    SHAPE->shapeType = SHAPE_PNG;
-                }
-            } else {
-                if (SHAPE->shapeType == SHAPE_SVG && !i.filename.ends_with(".svg"))
-                    return "meta invalid: cannot add .png files to an svg shape";
-                else if (SHAPE->shapeType == SHAPE_PNG && i.filename.ends_with(".svg"))
-                    return "meta invalid: cannot add .svg files to a png shape";
-            }
+    pack = themePack;
 
-            // load image
-            Debug::log(HC_LOG_TRACE, logFn, "Loading {} for shape {}", i.filename, cursor.path().stem().string());
-            auto* IMAGE  = LOADEDSHAPE.images.emplace_back(std::make_unique<SLoadedCursorImage>()).get();
-            IMAGE->side  = SHAPE->shapeType == SHAPE_SVG ? 0 : i.size;
-            IMAGE->delay = i.delay;
-            IMAGE->isSVG = SHAPE->shapeType == SHAPE_SVG;
-
-            index = zip_name_locate(zip, i.filename.c_str(), ZIP_FL_ENC_GUESS);
-            if (index == -1)
-                return "cursor" + cursor.path().string() + "failed to load image_file";
-
-            // read from zip
-            zip_file_t* image_file = zip_fopen_index(zip, index, ZIP_FL_UNCHANGED);
-            zip_stat_index(zip, index, ZIP_FL_UNCHANGED, &sb);
-
-            if (sb.valid & ZIP_STAT_SIZE) {
-                IMAGE->data    = new char[sb.size + 1];
-                IMAGE->dataLen = sb.size + 1;
-            } else {
-                IMAGE->data    = new char[static_cast<unsigned long>(1024 * 1024)]; /* 1MB should be more than enough, again. This probably should be in the spec. */
-                IMAGE->dataLen = static_cast<size_t>(1024 * 1024);
-            }
+    Debug::log(HC_LOG_TRACE, logFn, "loadThemePack: loaded {} shapes from {}", theme.shapes.size(), path);
 
-            IMAGE->dataLen = zip_fread(image_file, IMAGE->data, IMAGE->dataLen - 1);
+    return true;
+}
 
-            zip_fclose(image_file);
+std::optional<std::string> CHyprcursorImplementation::loadPackShapeImages(SCursorShape* shape, SLoadedCursorShape& loadedShape) {
+    const auto PACKSHAPE = pack->shape(loadedShape.packShape);
 
-            Debug::log(HC_LOG_TRACE, logFn, "Cairo: set up surface read");
+    for (uint32_t f = 0; f < PACKSHAPE->frameCount; ++f) {
+        const auto FRAME   = pack->frame(PACKSHAPE->firstFrame + f);
+        const auto PAYLOAD = FRAME ? pack->payload(*FRAME) : std::span<const uint8_t>{};
 
-            if (SHAPE->shapeType == SHAPE_PNG) {
+        if (PAYLOAD.empty())
+            return "frame " + std::to_string(f) + " is invalid";
 
-                IMAGE->cairoSurface = cairo_image_surface_create_from_png_stream(::readPNG, IMAGE);
+        shape->images.push_back(SCursorImage{.filename = std::string{pack->string(FRAME->filename, FRAME->filenameLen)}, .size = FRAME->size, .delay = FRAME->delay});
 
-                if (const auto STATUS = cairo_surface_status(IMAGE->cairoSurface); STATUS != CAIRO_STATUS_SUCCESS) {
-                    delete[] (char*)IMAGE->data;
-                    IMAGE->data = nullptr;
-                    return "Failed reading cairoSurface, status " + std::to_string((int)STATUS);
-                }
-            } else {
-                Debug::log(HC_LOG_TRACE, logFn, "Skipping cairo load for a svg surface");
+        auto* image      = loadedShape.images.emplace_back(std::make_unique<SLoadedCursorImage>()).get();
+        image->side      = shape->shapeType == SHAPE_SVG ? 0 : FRAME->size;
+        image->delay     = FRAME->delay;
+        image->isSVG     = shape->shapeType == SHAPE_SVG;
+        image->data      = (void*)PAYLOAD.data();
+        image->dataLen   = PAYLOAD.size();
+        image->dataOwned = false;
+
+        if (image->isSVG || decodeOnDemand)
+            continue;
+
+        if (const auto RET = decodeImage(image); RET.has_value())
+            return RET;
+    }
+
+    return {};
+}
+
+zip_t* CHyprcursorImplementation::openShapeArchive(SLoadedCursorShape& loadedShape) {
+    loadedShape.archive = std::make_shared<CMappedArchive>(loadedShape.archivePath);
+
+    if (loadedShape.archive->good()) {
+        if (const auto ZIP = loadedShape.archive->openZip(); ZIP)
+            return ZIP;
+    }
+
+    Debug::log(HC_LOG_TRACE, logFn, "openShapeArchive: couldn't map {}, reading it instead", loadedShape.archivePath);
+
+    loadedShape.archive.reset();
+
+    int errp = 0;
+    return zip_open(loadedShape.archivePath.c_str(), ZIP_RDONLY, &errp);
+}
+
+void CHyprcursorImplementation::closeShapeArchive(zip_t* zip, SLoadedCursorShape& loadedShape) {
+    zip_discard(zip);
+
+    // the mapping only needs to stay if images point into it
+    if (std::none_of(loadedShape.images.begin(), loadedShape.images.end(), [](const auto& i) { return i->data && !i->dataOwned; }))
+        loadedShape.archive.reset();
+}
+
+std::optional<std::string> CHyprcursorImplementation::loadShapeArchive(const std::filesystem::path& path, SCursorShape* shape, SLoadedCursorShape& loadedShape) {
+    zip_t* zip = openShapeArchive(loadedShape);
+
+    if (!zip)
+        return "cursor" + path.string() + "failed to open";
+
+    auto result = loadShapeMeta(zip, path, shape);
+
+    if (!result.has_value() && !lazy) {
+        result             = loadShapeImages(zip, shape, loadedShape);
+        loadedShape.loaded = true;
+    }
+
+    closeShapeArchive(zip, loadedShape);
+
+    return result;
+}
+
+std::optional<std::string> CHyprcursorImplementation::loadShapeMeta(zip_t* zip, const std::filesystem::path& path, SCursorShape* shape) {
+    zip_int64_t index    = zip_name_locate(zip, "meta.hl", ZIP_FL_ENC_GUESS);
+    bool        metaIsHL = true;
+
+    if (index == -1) {
+        index    = zip_name_locate(zip, "meta.toml", ZIP_FL_ENC_GUESS);
+        metaIsHL = false;
+    }
+
+    if (index == -1)
+        return "cursor" + path.string() + "failed to load meta";
+
+    auto&      scratch   = zipScratch();
+    const auto READBYTES = readZipEntry(zip, index, scratch);
+
+    if (READBYTES < 0)
+        return "cursor" + path.string() + "failed to read meta";
+
+    CMeta meta{std::string_view{scratch.data(), (size_t)READBYTES}, metaIsHL};
+
+    releaseZipScratch(scratch);
+
+    const auto METAPARSERESULT = meta.parse();
+    if (METAPARSERESULT.has_value())
+        return "cursor" + path.string() + "failed to parse meta: " + *METAPARSERESULT;
+
+    for (auto& i : meta.parsedData.definedSizes) {
+        shape->images.push_back(SCursorImage{.filename = i.file, .size = i.size, .delay = i.delayMs});
+    }
+
+    shape->overrides = meta.parsedData.overrides;
+
+    for (auto& i : shape->images) {
+        if (shape->shapeType == SHAPE_INVALID) {
+            if (i.filename.ends_with(".svg"))
+                shape->shapeType = SHAPE_SVG;
+            else if (i.filename.ends_with(".png"))
+                shape->shapeType = SHAPE_PNG;
+            else {
+                Debug::log(HC_LOG_WARN, logFn, "WARNING: image {} has no known extension, assuming png.", i.filename);
+                shape->shapeType = SHAPE_PNG;
             }
+        } else {
+            if (shape->shapeType == SHAPE_SVG && !i.filename.ends_with(".svg"))
+                return "meta invalid: cannot add .png files to an svg shape";
+            else if (shape->shapeType == SHAPE_PNG && i.filename.ends_with(".svg"))
+                return "meta invalid: cannot add .svg files to a png shape";
         }
+    }
+
+    if (shape->images.empty())
+        return "meta invalid: no images for shape " + path.stem().string();
+
+    shape->directory   = path.stem().string();
+    shape->hotspotX    = meta.parsedData.hotspotX;
+    shape->hotspotY    = meta.parsedData.hotspotY;
+    shape->nominalSize = meta.parsedData.nominalSize;
+    shape->resizeAlgo  = stringToAlgo(meta.parsedData.resizeAlgo);
+
+    return {};
+}
 
-        if (SHAPE->images.empty())
-            return "meta invalid: no images for shape " + cursor.path().stem().string();
+std::optional<std::string> CHyprcursorImplementation::loadShapeImages(zip_t* zip, SCursorShape* shape, SLoadedCursorShape& loadedShape) {
+    for (auto& i : shape->images) {
+        // load image
+        Debug::log(HC_LOG_TRACE, logFn, "Loading {} for shape {}", i.filename, shape->directory);
+        auto* IMAGE  = loadedShape.images.emplace_back(std::make_unique<SLoadedCursorImage>()).get();
+        IMAGE->side  = shape->shapeType == SHAPE_SVG ? 0 : i.size;
+        IMAGE->delay = i.delay;
+        IMAGE->isSVG = shape->shapeType == SHAPE_SVG;
+
+        // uncompressed entries can be used straight from the mapping
+        if (const auto STORED = loadedShape.archive ? loadedShape.archive->storedEntry(i.filename) : std::span<const uint8_t>{}; !STORED.empty()) {
+            IMAGE->data      = (void*)STORED.data();
+            IMAGE->dataLen   = STORED.size();
+            IMAGE->dataOwned = false;
+        } else if (const auto RESULT = readImageFromZip(zip, i.filename, IMAGE); RESULT.has_value())
+            return "cursor" + loadedShape.archivePath + *RESULT;
 
-        SHAPE->directory   = cursor.path().stem().string();
-        SHAPE->hotspotX    = meta.parsedData.hotspotX;
-        SHAPE->hotspotY    = meta.parsedData.hotspotY;
-        SHAPE->nominalSize = meta.parsedData.nominalSize;
-        SHAPE->resizeAlgo  = stringToAlgo(meta.parsedData.resizeAlgo);
+        if (shape->shapeType == SHAPE_PNG) {
+            if (decodeOnDemand)
+                continue;
 
-        zip_discard(zip);
+            if (const auto RESULT = decodeImage(IMAGE); RESULT.has_value())
+                return *RESULT;
+        } else {
+            Debug::log(HC_LOG_TRACE, logFn, "Skipping cairo load for a svg surface");
+        }
     }
 
     return {};
 }
 
-std::vector<SLoadedCursorImage*> CHyprcursorImplementation::getFramesFor(SCursorShape* shape, int size) {
-    std::vector<SLoadedCursorImage*> frames;
+std::optional<std::string> CHyprcursorImplementation::readImageFromZip(zip_t* zip, const std::string& name, SLoadedCursorImage* image) {
+    const auto index = zip_name_locate(zip, name.c_str(), ZIP_FL_ENC_GUESS);
+    if (index == -1)
+        return "failed to load image_file";
 
-    for (auto& image : loadedShapes[shape].images) {
-        if (!image->isSVG && image->side != size)
+    // read from zip
+    if (const auto SIZE = zipEntrySize(zip, index); SIZE.has_value()) {
+        image->data    = new char[std::max(*SIZE, (zip_uint64_t)1)];
+        image->dataLen = *SIZE;
+
+        zip_file_t* image_file = zip_fopen_index(zip, index, ZIP_FL_UNCHANGED);
+        if (!image_file)
+            return "failed to open image_file";
+
+        const auto READBYTES = readZipFile(image_file, (char*)image->data, image->dataLen);
+        zip_fclose(image_file);
+
+        if (READBYTES < 0)
+            return "failed to read image_file";
+
+        image->dataLen = READBYTES;
+        return {};
+    }
+
+    // no size in the central directory, stream it and copy out what we got
+    auto&      scratch   = zipScratch();
+    const auto READBYTES = readZipEntry(zip, index, scratch);
+
+    if (READBYTES < 0) {
+        releaseZipScratch(scratch);
+        return "failed to read image_file";
+    }
+
+    image->data    = new char[std::max(READBYTES, (zip_int64_t)1)];
+    image->dataLen = READBYTES;
+    std::memcpy(image->data, scratch.data(), READBYTES);
+
+    releaseZipScratch(scratch);
+
+    return {};
+}
+
+std::optional<std::string> CHyprcursorImplementation::decodeImage(SLoadedCursorImage* image) {
+    Debug::log(HC_LOG_TRACE, logFn, "Cairo: set up surface read");
+
+    image->readNeedle   = 0;
+    image->cairoSurface = cairo_image_surface_create_from_png_stream(::readPNG, image);
+
+    if (const auto STATUS = cairo_surface_status(image->cairoSurface); STATUS != CAIRO_STATUS_SUCCESS) {
+        cairo_surface_destroy(image->cairoSurface);
+        image->cairoSurface = nullptr;
+        return "Failed reading cairoSurface, status " + std::to_string((int)STATUS);
+    }
+
+    return {};
+}
+
+bool CHyprcursorImplementation::ensureImageDecoded(SLoadedCursorImage* image) {
+    if (image->cairoSurface || image->isSVG || image->artificial)
+        return true;
+
+    if (!image->data)
+        return false;
+
+    if (const auto RESULT = decodeImage(image); RESULT.has_value()) {
+        Debug::log(HC_LOG_ERR, logFn, "ensureImageDecoded: {}", *RESULT);
+        return false;
+    }
+
+    return true;
+}
+
+bool CHyprcursorImplementation::ensureShapeLoaded(SCursorShape* shape) {
+    auto& loadedShape = loadedShapes.at(shape);
+
+    if (loadedShape.loaded)
+        return !loadedShape.images.empty();
+
+    // only try once, a broken archive won't fix itself
+    loadedShape.loaded = true;
+
+    Debug::log(HC_LOG_TRACE, logFn, "ensureShapeLoaded: loading {}", shape->directory);
+
+    if (pack) {
+        if (const auto RESULT = loadPackShapeImages(shape, loadedShape); RESULT.has_value()) {
+            Debug::log(HC_LOG_ERR, logFn, "ensureShapeLoaded: shape {} failed to load from the pack with {}", shape->directory, *RESULT);
+            shape->images.clear();
+            loadedShape.images.clear();
+            return false;
+        }
+
+        return true;
+    }
+
+    zip_t* zip = openShapeArchive(loadedShape);
+
+    if (!zip) {
+        Debug::log(HC_LOG_ERR, logFn, "ensureShapeLoaded: failed to open {}", loadedShape.archivePath);
+        return false;
+    }
+
+    const auto RESULT = loadShapeImages(zip, shape, loadedShape);
+
+    if (RESULT.has_value())
+        loadedShape.images.clear();
+
+    closeShapeArchive(zip, loadedShape);
+
+    if (RESULT.has_value()) {
+        Debug::log(HC_LOG_ERR, logFn, "ensureShapeLoaded: shape {} failed to load with {}", shape->directory, *RESULT);
+        return false;
+    }
+
+    return true;
+}
+
+static std::vector<SCursorImageData> makeShapeView(SCursorShape* shape, const std::vector<SLoadedCursorImage*>& images) {
+    std::vector<SCursorImageData> view;
+    view.reserve(images.size());
+
+    for (auto& image : images) {
+        view.push_back(SCursorImageData{
+            .surface  = image->cairoSurface,
+            .size     = image->side,
+            .delay    = image->delay,
+            .hotspotX = (int)std::round(shape->hotspotX * (float)image->side),
+            .hotspotY = (int)std::round(shape->hotspotY * (float)image->side),
+        });
+    }
+
+    return view;
+}
+
+bool CHyprcursorImplementation::resolveNativeImages(SCursorShape* shape, const Hyprcursor::SCursorStyleInfo& info, std::vector<SLoadedCursorImage*>& resultingImages) {
+    if (!ensureShapeLoaded(shape))
+        return false;
+
+    const int PIXELSIDE = std::round(info.size / shape->nominalSize);
+
+    // matched :)
+    bool foundAny = false;
+    for (auto& image : loadedShapes.at(shape).images) {
+        if (image->side != PIXELSIDE)
             continue;
 
-        if (image->artificial)
+        if (!ensureImageDecoded(image.get()))
+            continue;
+
+        // found size
+        resultingImages.push_back(image.get());
+        foundAny = true;
+    }
+
+    if (!foundAny && shape->shapeType != SHAPE_SVG /* something broke, this shouldn't happen with svg */) {
+        // if we get here, means loadThemeStyle wasn't called most likely. If resize algo is specified, this is an error.
+        if (shape->resizeAlgo != HC_RESIZE_NONE) {
+            Debug::log(HC_LOG_ERR, logFn, "getSurfaceFor didn't match a size?");
+            return false;
+        }
+
+        // find nearest
+        int leader = 13371337;
+        for (auto& image : loadedShapes.at(shape).images) {
+            if (std::abs((int)(image->side - PIXELSIDE)) > std::abs((int)(leader - PIXELSIDE)))
+                continue;
+
+            leader = image->side;
+        }
+
+        if (leader == 13371337) { // ???
+            Debug::log(HC_LOG_ERR, logFn, "getSurfaceFor didn't match any nearest size?");
+            return false;
+        }
+
+        // we found nearest size
+        for (auto& image : loadedShapes.at(shape).images) {
+            if (image->side != leader)
+                continue;
+
+            if (!ensureImageDecoded(image.get()))
+                continue;
+
+            // found size
+            resultingImages.push_back(image.get());
+            foundAny = true;
+        }
+
+        if (!foundAny) {
+            Debug::log(HC_LOG_ERR, logFn, "getSurfaceFor didn't match any nearest size (2)?");
+            return false;
+        }
+    }
+
+    return true;
+}
+
+const std::vector<SCursorImageData>* CHyprcursorImplementation::getShapeView(SCursorShape* shape, const Hyprcursor::SCursorStyleInfo& info) {
+    // a loaded style has frames of its own
+    if (const auto IT = styles.find(info.size); IT != styles.end())
+        return getStyleShapeView(IT->second.get(), shape);
+
+    const SShapeViewKey KEY{shape, info.size};
+
+    if (const auto IT = shapeViews.find(KEY); IT != shapeViews.end())
+        return &IT->second;
+
+    std::vector<SLoadedCursorImage*> resultingImages;
+
+    // the loader might be reading this shape for a style
+    std::unique_lock<std::shared_mutex> lock(loadedShapes.at(shape).mutex);
+
+    if (!resolveNativeImages(shape, info, resultingImages))
+        return nullptr;
+
+    auto& view = shapeViews[KEY];
+    view       = makeShapeView(shape, resultingImages);
+
+    return &view;
+}
+
+std::optional<std::string> CHyprcursorImplementation::planShapeFrames(SCursorShape* shape, unsigned int size, std::vector<SStyleRenderJob>& jobs) {
+    if (shape->resizeAlgo == HC_RESIZE_NONE && shape->shapeType != SHAPE_SVG) {
+        // don't resample NONE style cursors
+        Debug::log(HC_LOG_TRACE, logFn, "planShapeFrames: ignoring {}", shape->directory);
+        return std::nullopt;
+    }
+
+    if (!ensureShapeLoaded(shape)) {
+        Debug::log(HC_LOG_ERR, logFn, "planShapeFrames: skipping broken shape {}", shape->directory);
+        return std::nullopt;
+    }
+
+    const int PIXELSIDE = std::round(size / shape->nominalSize);
+
+    if (shape->shapeType == SHAPE_PNG) {
+        for (auto& image : loadedShapes.at(shape).images) {
+            // size was found, nothing to resample.
+            if (image->side == PIXELSIDE)
+                return std::nullopt;
+        }
+
+        SLoadedCursorImage* leader    = nullptr;
+        int                 leaderVal = 1000000;
+        for (auto& image : loadedShapes.at(shape).images) {
+            if (image->side < PIXELSIDE)
+                continue;
+
+            if (image->side > leaderVal)
+                continue;
+
+            leaderVal = image->side;
+            leader    = image.get();
+        }
+
+        if (!leader) {
+            for (auto& image : loadedShapes.at(shape).images) {
+                if (std::abs((int)(image->side - PIXELSIDE)) > leaderVal)
+                    continue;
+
+                leaderVal = image->side;
+                leader    = image.get();
+            }
+        }
+
+        if (!leader)
+            return "Resampling failed to find a candidate???";
+
+        auto FRAMES = getFramesFor(shape, leader->side);
+
+        // a mip level between the target and the leader is cheaper to start from, and aliases less
+        if (mipmaps && leader->side >= PIXELSIDE * 2) {
+            if (auto levelFrames = getMipFramesFor(shape, PIXELSIDE); !levelFrames.empty() && levelFrames.front()->side < leader->side)
+                FRAMES = std::move(levelFrames);
+        }
+
+        Debug::log(HC_LOG_TRACE, logFn, "planShapeFrames: png shape {} has {} frames, nominal {:.2f}, pixel size will be {}x", shape->directory, FRAMES.size(),
+                   shape->nominalSize, PIXELSIDE);
+
+        for (auto& f : FRAMES) {
+            jobs.emplace_back(SStyleRenderJob{.shape = shape, .source = f, .side = PIXELSIDE});
+        }
+    } else if (shape->shapeType == SHAPE_SVG) {
+        const auto FRAMES = getFramesFor(shape, 0);
+
+        Debug::log(HC_LOG_TRACE, logFn, "planShapeFrames: svg shape {} has {} frames, nominal {:.2f}, pixel size will be {}x", shape->directory, FRAMES.size(),
+                   shape->nominalSize, PIXELSIDE);
+
+        for (auto& f : FRAMES) {
+            // parsed, or recorded, once here, then only rendered for every size
+            if (const auto RET = svgDisplayLists ? ensureSvgRecorded(f) : ensureSvgParsed(f); RET.has_value())
+                return RET;
+
+            jobs.emplace_back(SStyleRenderJob{.shape = shape, .source = f, .side = PIXELSIDE});
+        }
+    } else
+        return "Invalid shapetype in planShapeFrames";
+
+    return std::nullopt;
+}
+
+// whether cairo filters an algorithm smoothly. Only bilinear did before the resampler, box and lanczos have no
+// cairo equivalent and get the closest one, anything else is sampled.
+static bool cairoSmooths(eHyprcursorResizeAlgo algo) {
+    return algo == HC_RESIZE_BILINEAR || algo == HC_RESIZE_BOX || algo == HC_RESIZE_LANCZOS;
+}
+
+// runs on the render pool: only touches the job's own image and reads its source
+static std::optional<std::string> renderStyleFrame(SStyleRenderJob& job) {
+    const auto SHAPE     = job.shape;
+    const auto SOURCE    = job.source;
+    const int  PIXELSIDE = job.side;
+
+    job.image                = std::make_unique<SLoadedCursorImage>();
+    auto& newImage           = job.image;
+    newImage->artificial     = true;
+    newImage->side           = PIXELSIDE;
+    newImage->artificialData = new char[static_cast<unsigned long>(PIXELSIDE * PIXELSIDE * 4)];
+    newImage->cairoSurface   = cairo_image_surface_create_for_data((unsigned char*)newImage->artificialData, CAIRO_FORMAT_ARGB32, PIXELSIDE, PIXELSIDE, PIXELSIDE * 4);
+    newImage->delay          = SOURCE->delay;
+
+    // the png's own dimensions, nothing guarantees they match the size meta.hl gave it
+    const int SOURCEW = SHAPE->shapeType == SHAPE_PNG ? cairo_image_surface_get_width(SOURCE->cairoSurface) : 0;
+    const int SOURCEH = SHAPE->shapeType == SHAPE_PNG ? cairo_image_surface_get_height(SOURCE->cairoSurface) : 0;
+
+    if (SHAPE->shapeType == SHAPE_PNG && cairo_image_surface_get_format(SOURCE->cairoSurface) == CAIRO_FORMAT_ARGB32) {
+        cairo_surface_flush(SOURCE->cairoSurface);
+
+        if (Resample::resample(cairo_image_surface_get_data(SOURCE->cairoSurface), SOURCEW, SOURCEH, cairo_image_surface_get_stride(SOURCE->cairoSurface),
+                               (uint8_t*)newImage->artificialData, PIXELSIDE, PIXELSIDE, PIXELSIDE * 4, SHAPE->resizeAlgo)) {
+            cairo_surface_mark_dirty(newImage->cairoSurface);
+            return std::nullopt;
+        }
+    }
+
+    // opaque pngs decode to RGB24, those and svgs go through cairo
+    const auto PCAIRO = cairo_create(newImage->cairoSurface);
+
+    if (SHAPE->shapeType == SHAPE_PNG)
+        cairo_set_antialias(PCAIRO, cairoSmooths(SHAPE->resizeAlgo) ? CAIRO_ANTIALIAS_GOOD : CAIRO_ANTIALIAS_NONE);
+
+    cairo_save(PCAIRO);
+    cairo_set_operator(PCAIRO, CAIRO_OPERATOR_CLEAR);
+    cairo_paint(PCAIRO);
+    cairo_restore(PCAIRO);
+
+    if (SHAPE->shapeType == SHAPE_PNG) {
+        const auto PTN = cairo_pattern_create_for_surface(SOURCE->cairoSurface);
+        cairo_pattern_set_extend(PTN, CAIRO_EXTEND_NONE);
+        // same mapping as the resampler, the whole png to the whole frame
+        if (SOURCEW > 0 && SOURCEH > 0)
+            cairo_scale(PCAIRO, PIXELSIDE / (double)SOURCEW, PIXELSIDE / (double)SOURCEH);
+        cairo_pattern_set_filter(PTN, cairoSmooths(SHAPE->resizeAlgo) ? CAIRO_FILTER_GOOD : CAIRO_FILTER_NEAREST);
+        cairo_set_source(PCAIRO, PTN);
+
+        cairo_rectangle(PCAIRO, 0, 0, PIXELSIDE, PIXELSIDE);
+
+        cairo_fill(PCAIRO);
+        cairo_surface_flush(newImage->cairoSurface);
+
+        cairo_pattern_destroy(PTN);
+        cairo_destroy(PCAIRO);
+
+        return std::nullopt;
+    }
+
+    GError*       error = nullptr;
+    RsvgRectangle rect  = {0, 0, (double)PIXELSIDE, (double)PIXELSIDE};
+
+    bool          rendered = false;
+    {
+        // recordings build indices on first replay, so they're not safe to share between threads either
+        std::lock_guard<std::mutex> lg(SOURCE->svgMutex);
+
+        if (SOURCE->svgRecording) {
+            const double SCALE = PIXELSIDE / (double)SVG_RECORDING_SIDE;
+            cairo_scale(PCAIRO, SCALE, SCALE);
+            cairo_set_source_surface(PCAIRO, SOURCE->svgRecording, 0, 0);
+            cairo_paint(PCAIRO);
+            rendered = cairo_status(PCAIRO) == CAIRO_STATUS_SUCCESS;
+        } else
+            rendered = SOURCE->svgHandle && rsvg_handle_render_document(SOURCE->svgHandle, PCAIRO, &rect, &error);
+    }
+
+    if (!rendered) {
+        const std::string ERR = std::format("Failed rendering svg: {}", error ? error->message : "not parsed");
+        if (error)
+            g_error_free(error);
+        cairo_destroy(PCAIRO);
+        return ERR;
+    }
+
+    // done
+    cairo_surface_flush(newImage->cairoSurface);
+    cairo_destroy(PCAIRO);
+
+    return std::nullopt;
+}
+
+void CHyprcursorImplementation::renderStyleJobs(std::span<SStyleRenderJob> jobs, std::span<std::optional<std::string>> results, const std::atomic<bool>* cancelled) {
+    Parallel::forEach(jobs.size(), std::max(loadThreads, 1U), [&](size_t i) {
+        if (cancelled && *cancelled)
+            return;
+
+        // keeps the sources from being trimmed or replaced, frames of one shape can still render at once
+        std::shared_lock<std::shared_mutex> lock(loadedShapes.at(jobs[i].shape).mutex);
+
+        results[i] = renderStyleFrame(jobs[i]);
+    });
+}
+
+std::optional<std::string> CHyprcursorImplementation::renderStyleShapes(SCursorStyleC* style, std::span<SCursorShape* const> shapes) {
+    std::vector<SStyleRenderJob> jobs;
+
+    for (auto& shape : shapes) {
+        if (!style->rendered.emplace(shape).second)
+            continue;
+
+        std::unique_lock<std::shared_mutex> lock(loadedShapes.at(shape).mutex);
+
+        if (const auto RET = planShapeFrames(shape, style->info.size, jobs); RET.has_value())
+            return RET;
+    }
+
+    if (jobs.empty())
+        return std::nullopt;
+
+    std::vector<std::optional<std::string>> results(jobs.size());
+    renderStyleJobs(jobs, results, nullptr);
+
+    for (auto& r : results) {
+        if (r.has_value())
+            return r;
+    }
+
+    // everything rendered, only now do the frames become visible
+    for (auto& job : jobs) {
+        style->frames[job.shape].emplace_back(std::move(job.image));
+    }
+
+    Debug::log(HC_LOG_TRACE, logFn, "renderStyleShapes: rendered {} frames for size {}", jobs.size(), style->info.size);
+
+    return std::nullopt;
+}
+
+// rendered first by async loads, so a pointer shows up as soon as possible
+constexpr std::array<std::string_view, 6> PRIORITY_SHAPES = {"default", "left_ptr", "text", "xterm", "pointer", "hand2"};
+
+std::optional<std::string> CHyprcursorImplementation::startStyleLoad(SCursorStyleC* style) {
+    std::vector<SCursorShape*> shapes;
+    shapes.reserve(theme.shapes.size());
+
+    for (auto& name : PRIORITY_SHAPES) {
+        const auto ENTRY = shapeIndex.find(name);
+
+        if (ENTRY && std::ranges::find(shapes, ENTRY->shape) == shapes.end())
+            shapes.emplace_back(ENTRY->shape);
+    }
+
+    const size_t PRIORITYSHAPES = shapes.size();
+
+    for (auto& shape : theme.shapes) {
+        if (std::ranges::find(shapes, shape.get()) == shapes.end())
+            shapes.emplace_back(shape.get());
+    }
+
+    // nothing is read or decoded here, the loader does all of that. Until it's done, every shape is pending.
+    auto load   = std::make_unique<SStyleLoad>();
+    load->style = style;
+    load->size  = style->info.size;
+
+    for (size_t i = 0; i < shapes.size(); ++i) {
+        if (!style->rendered.emplace(shapes[i]).second)
+            continue;
+
+        load->batches[i < PRIORITYSHAPES ? 0 : 1].shapes.emplace_back(shapes[i]);
+        style->pending.emplace(shapes[i]);
+    }
+
+    if (load->batches[0].shapes.empty() && load->batches[1].shapes.empty())
+        return std::nullopt;
+
+    style->loading = true;
+
+    Debug::log(HC_LOG_TRACE, logFn, "startStyleLoad: size {} has {} shapes to load, {} first", style->info.size,
+               load->batches[0].shapes.size() + load->batches[1].shapes.size(), load->batches[0].shapes.size());
+
+    const auto LOAD = styleLoads.emplace_back(std::move(load)).get();
+
+    if (!styleLoader.joinable()) {
+        try {
+            styleLoader = std::thread([this]() { styleLoaderMain(); });
+        } catch (std::system_error& e) {
+            // nothing to load in the background on, so load it now. It's committed on dispatch, like it would be otherwise.
+            Debug::log(HC_LOG_WARN, logFn, "startStyleLoad: can't start the loader: {}, loading size {} now", e.what(), style->info.size);
+            runStyleLoad(*LOAD);
+            return std::nullopt;
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lg(styleLoaderMutex);
+        styleLoadQueue.push_back(LOAD);
+    }
+
+    styleLoaderCV.notify_all();
+
+    return std::nullopt;
+}
+
+void CHyprcursorImplementation::styleLoaderMain() {
+    std::unique_lock<std::mutex> lock(styleLoaderMutex);
+
+    while (true) {
+        styleLoaderCV.wait(lock, [this]() { return styleLoaderExit || !styleLoadQueue.empty(); });
+
+        if (styleLoaderExit)
+            return;
+
+        const auto LOAD = styleLoadQueue.front();
+        styleLoadQueue.pop_front();
+
+        lock.unlock();
+        runStyleLoad(*LOAD);
+        lock.lock();
+    }
+}
+
+void CHyprcursorImplementation::runStyleLoad(SStyleLoad& load) {
+    for (size_t b = 0; b < load.batches.size(); ++b) {
+        auto& batch = load.batches[b];
+
+        for (auto& shape : batch.shapes) {
+            if (load.cancelled)
+                break;
+
+            // reads, decodes, and for svgs parses or records, whatever the shape needs
+            std::unique_lock<std::shared_mutex> lock(loadedShapes.at(shape).mutex);
+
+            const auto                          JOBS = batch.jobs.size();
+
+            if (const auto RET = planShapeFrames(shape, load.size, batch.jobs); RET.has_value()) {
+                // uses the theme's images, like a shape that failed rendering
+                Debug::log(HC_LOG_ERR, logFn, "runStyleLoad: failed loading {} at size {}: {}", shape->directory, load.size, *RET);
+                batch.jobs.erase(batch.jobs.begin() + JOBS, batch.jobs.end());
+            }
+        }
+
+        batch.results.resize(batch.jobs.size());
+        renderStyleJobs(batch.jobs, batch.results, &load.cancelled);
+
+        if (b == 0 && !load.batches[1].shapes.empty()) {
+            load.stage = SStyleLoad::STAGE_PRIORITY_DONE;
+            eventfd_write(styleLoadFD, 1);
+        }
+    }
+
+    // the load can be freed as soon as it's done, so it's not touched after this
+    {
+        std::lock_guard<std::mutex> lg(styleLoaderMutex);
+        load.stage = SStyleLoad::STAGE_DONE;
+    }
+
+    styleLoaderCV.notify_all();
+    eventfd_write(styleLoadFD, 1);
+}
+
+void CHyprcursorImplementation::commitStyleBatch(SStyleLoad& load, SStyleLoad::SBatch& batch) {
+    const auto                        STYLE = load.style;
+
+    std::unordered_set<SCursorShape*> failed;
+
+    for (size_t i = 0; i < batch.jobs.size(); ++i) {
+        if (!batch.results[i].has_value() && batch.jobs[i].image)
+            continue;
+
+        if (failed.emplace(batch.jobs[i].shape).second)
+            Debug::log(HC_LOG_ERR, logFn, "commitStyleBatch: failed rendering {} at size {}: {}", batch.jobs[i].shape->directory, STYLE->info.size,
+                       batch.results[i].value_or("cancelled"));
+    }
+
+    // failed shapes fall back to the theme's images, like they would when loaded synchronously
+    for (auto& job : batch.jobs) {
+        if (!failed.contains(job.shape))
+            STYLE->frames[job.shape].emplace_back(std::move(job.image));
+    }
+
+    // shapes without jobs had nothing to render, and use the theme's images from now on too
+    for (auto& shape : batch.shapes) {
+        STYLE->pending.erase(shape);
+        STYLE->views.erase(shape);
+        STYLE->borrowed.erase(shape);
+    }
+}
+
+void CHyprcursorImplementation::commitStyleLoad(SStyleLoad& load) {
+    if (load.committedStage < SStyleLoad::STAGE_PRIORITY_DONE)
+        commitStyleBatch(load, load.batches[0]);
+
+    commitStyleBatch(load, load.batches[1]);
+
+    load.committedStage = SStyleLoad::STAGE_DONE;
+    load.style->loading = false;
+}
+
+unsigned int CHyprcursorImplementation::dispatchStyleLoads() {
+    unsigned int finished = 0;
+
+    std::erase_if(styleLoads, [&](std::unique_ptr<SStyleLoad>& load) {
+        const auto STAGE = load->stage.load();
+
+        if (!load->style)
+            return STAGE == SStyleLoad::STAGE_DONE;
+
+        if (STAGE >= SStyleLoad::STAGE_PRIORITY_DONE && load->committedStage < SStyleLoad::STAGE_PRIORITY_DONE) {
+            commitStyleBatch(*load, load->batches[0]);
+            load->committedStage = SStyleLoad::STAGE_PRIORITY_DONE;
+        }
+
+        if (STAGE != SStyleLoad::STAGE_DONE)
+            return false;
+
+        commitStyleLoad(*load);
+
+        Debug::log(HC_LOG_INFO, logFn, "dispatchStyleLoads: size {} done", load->size);
+
+        finished++;
+        return true;
+    });
+
+    return finished;
+}
+
+void CHyprcursorImplementation::finishStyleLoads(SCursorStyleC* style) {
+    for (auto& load : styleLoads) {
+        if (style && load->style != style)
+            continue;
+
+        std::unique_lock<std::mutex> lock(styleLoaderMutex);
+
+        // not started yet, so do it here instead of waiting for the loads queued before it
+        if (const auto IT = std::ranges::find(styleLoadQueue, load.get()); IT != styleLoadQueue.end()) {
+            styleLoadQueue.erase(IT);
+            lock.unlock();
+            runStyleLoad(*load);
+            continue;
+        }
+
+        styleLoaderCV.wait(lock, [&load]() { return load->stage == SStyleLoad::STAGE_DONE; });
+    }
+
+    // everything matching is done now
+    std::erase_if(styleLoads, [&](std::unique_ptr<SStyleLoad>& load) {
+        if (load->stage != SStyleLoad::STAGE_DONE)
+            return false;
+
+        if (load->style)
+            commitStyleLoad(*load);
+
+        return true;
+    });
+}
+
+void CHyprcursorImplementation::cancelStyleLoad(SCursorStyleC* style) {
+    for (auto& load : styleLoads) {
+        if (load->style != style)
+            continue;
+
+        load->cancelled = true;
+        load->style     = nullptr;
+    }
+}
+
+void CHyprcursorImplementation::takeManagerState(CHyprcursorImplementation& other) {
+    requestedThemeName = other.requestedThemeName;
+    lazy               = other.lazy;
+    loadThreads        = other.loadThreads;
+    decodeOnDemand     = other.decodeOnDemand;
+    lazyStyles         = other.lazyStyles;
+    mipmaps            = other.mipmaps;
+    svgDisplayLists    = other.svgDisplayLists;
+    watcher            = std::move(other.watcher);
+    styleLoadFD        = other.styleLoadFD;
+}
+
+CHyprcursorImplementation::~CHyprcursorImplementation() {
+    // sources belong to us, so the loader can't outlive us. Whatever it's on stops early, the rest never starts.
+    {
+        std::lock_guard<std::mutex> lg(styleLoaderMutex);
+
+        for (auto& load : styleLoads) {
+            load->cancelled = true;
+        }
+
+        styleLoadQueue.clear();
+        styleLoaderExit = true;
+    }
+
+    styleLoaderCV.notify_all();
+
+    if (styleLoader.joinable())
+        styleLoader.join();
+}
+
+bool CHyprcursorImplementation::resolveFallbackImages(SCursorStyleC* style, SCursorShape* shape, std::vector<SLoadedCursorImage*>& resultingImages) {
+    const int PIXELSIDE = std::round(style->info.size / shape->nominalSize);
+
+    int       leader = -1;
+
+    // frames of other styles, referenced so releasing that style doesn't free them under our view
+    auto& borrowed = style->borrowed[shape];
+    borrowed.clear();
+
+    for (auto& [size, other] : styles) {
+        if (other.get() == style || other->pending.contains(shape))
+            continue;
+
+        const auto IT = other->frames.find(shape);
+        if (IT == other->frames.end() || IT->second.empty())
+            continue;
+
+        const int SIDE = IT->second.front()->side;
+        if (leader != -1 && std::abs(SIDE - PIXELSIDE) >= std::abs(leader - PIXELSIDE))
+            continue;
+
+        leader   = SIDE;
+        borrowed = IT->second;
+        resultingImages.clear();
+
+        for (auto& f : IT->second) {
+            resultingImages.push_back(f.get());
+        }
+    }
+
+    if (!ensureShapeLoaded(shape))
+        return leader != -1;
+
+    // and the theme's own sizes, svgs have none to offer
+    int nativeLeader = -1;
+    for (auto& image : loadedShapes.at(shape).images) {
+        if (image->isSVG || image->artificial)
+            continue;
+
+        if (nativeLeader != -1 && std::abs(image->side - PIXELSIDE) >= std::abs(nativeLeader - PIXELSIDE))
+            continue;
+
+        nativeLeader = image->side;
+    }
+
+    if (nativeLeader != -1 && (leader == -1 || std::abs(nativeLeader - PIXELSIDE) < std::abs(leader - PIXELSIDE))) {
+        auto frames = getFramesFor(shape, nativeLeader);
+
+        if (!frames.empty()) {
+            leader          = nativeLeader;
+            resultingImages = std::move(frames);
+            borrowed.clear();
+        }
+    }
+
+    return leader != -1;
+}
+
+const std::vector<SCursorImageData>* CHyprcursorImplementation::getStyleShapeView(SCursorStyleC* style, SCursorShape* shape) {
+    if (const auto IT = style->views.find(shape); IT != style->views.end())
+        return &IT->second;
+
+    // still rendering in the background, meanwhile serve the nearest size available
+    if (style->pending.contains(shape)) {
+        std::vector<SLoadedCursorImage*>    resultingImages;
+        std::unique_lock<std::shared_mutex> lock(loadedShapes.at(shape).mutex);
+
+        if (!resolveFallbackImages(style, shape, resultingImages))
+            return nullptr;
+
+        auto& view = style->views[shape];
+        view       = makeShapeView(shape, resultingImages);
+
+        return &view;
+    }
+
+    // lazy styles rasterize a shape the first time it's asked for
+    if (const auto RET = renderStyleShapes(style, std::span{&shape, 1}); RET.has_value()) {
+        Debug::log(HC_LOG_ERR, logFn, "getShapeView: failed rendering {} at size {}: {}", shape->directory, style->info.size, RET.value());
+        return nullptr;
+    }
+
+    std::vector<SLoadedCursorImage*>    resultingImages;
+    std::unique_lock<std::shared_mutex> lock(loadedShapes.at(shape).mutex);
+
+    // shapes that weren't resampled for this style use the theme's own images
+    if (const auto FRAMES = style->frames.find(shape); FRAMES != style->frames.end() && !FRAMES->second.empty()) {
+        for (auto& f : FRAMES->second) {
+            resultingImages.push_back(f.get());
+        }
+    } else if (!resolveNativeImages(shape, style->info, resultingImages))
+        return nullptr;
+
+    auto& view = style->views[shape];
+    view       = makeShapeView(shape, resultingImages);
+
+    return &view;
+}
+
+void CHyprcursorImplementation::buildCursorShapeHandles() {
+    cursorShapeHandles.fill(0);
+
+    // names are listed css name first, so the first one the theme has wins
+    for (auto& name : CursorShapes::NAMES) {
+        if (cursorShapeHandles[name.shape] != 0)
+            continue;
+
+        if (const auto ENTRY = shapeIndex.find(name.name); ENTRY)
+            cursorShapeHandles[name.shape] = ENTRY->handle;
+    }
+}
+
+void CHyprcursorImplementation::dropShapeViews(unsigned int size) {
+    std::erase_if(shapeViews, [size](const auto& e) { return e.first.size == size; });
+}
+
+std::optional<std::string> CHyprcursorImplementation::ensureSvgParsed(SLoadedCursorImage* image) {
+    if (!image->isSVG || image->svgHandle)
+        return std::nullopt;
+
+    GError* error    = nullptr;
+    image->svgHandle = rsvg_handle_new_from_data((unsigned char*)image->data, image->dataLen, &error);
+
+    if (!image->svgHandle) {
+        const std::string ERR = std::format("Failed reading svg: {}", error->message);
+        g_error_free(error);
+        return ERR;
+    }
+
+    return std::nullopt;
+}
+
+std::optional<std::string> CHyprcursorImplementation::ensureSvgRecorded(SLoadedCursorImage* image) {
+    if (!image->isSVG || image->svgRecording)
+        return std::nullopt;
+
+    if (const auto RET = ensureSvgParsed(image); RET.has_value())
+        return RET;
+
+    const cairo_rectangle_t EXTENTS = {0, 0, (double)SVG_RECORDING_SIDE, (double)SVG_RECORDING_SIDE};
+    const auto              SURFACE = cairo_recording_surface_create(CAIRO_CONTENT_COLOR_ALPHA, &EXTENTS);
+    const auto              PCAIRO  = cairo_create(SURFACE);
+
+    GError*                 error = nullptr;
+    RsvgRectangle           rect  = {0, 0, (double)SVG_RECORDING_SIDE, (double)SVG_RECORDING_SIDE};
+
+    const bool              RECORDED = rsvg_handle_render_document(image->svgHandle, PCAIRO, &rect, &error) && cairo_status(PCAIRO) == CAIRO_STATUS_SUCCESS;
+
+    cairo_destroy(PCAIRO);
+
+    if (!RECORDED) {
+        const std::string ERR = std::format("Failed recording svg: {}", error ? error->message : "cairo error");
+        if (error)
+            g_error_free(error);
+        cairo_surface_destroy(SURFACE);
+        return ERR;
+    }
+
+    // the recording is all later sizes need
+    image->svgRecording = SURFACE;
+    g_object_unref(image->svgHandle);
+    image->svgHandle = nullptr;
+
+    return std::nullopt;
+}
+
+std::vector<SLoadedCursorImage*> CHyprcursorImplementation::getMipFramesFor(SCursorShape* shape, int side) {
+    auto& loadedShape = loadedShapes.at(shape);
+
+    int   largest = 0;
+    for (auto& image : loadedShape.images) {
+        if (!image->isSVG && !image->artificial)
+            largest = std::max(largest, image->side);
+    }
+
+    auto level = getFramesFor(shape, largest);
+
+    for (size_t i = 0; !level.empty() && (level.front()->side + 1) / 2 >= side; ++i) {
+        if (i == loadedShape.mips.size()) {
+            // each level halves the one above it
+            auto& next = loadedShape.mips.emplace_back();
+
+            for (auto& f : level) {
+                if (cairo_image_surface_get_format(f->cairoSurface) != CAIRO_FORMAT_ARGB32) {
+                    loadedShape.mips.pop_back();
+                    return {};
+                }
+
+                // halves what the surface really has, the declared size can be off
+                const int W     = cairo_image_surface_get_width(f->cairoSurface);
+                const int H     = cairo_image_surface_get_height(f->cairoSurface);
+                const int HALFW = (W + 1) / 2;
+                const int HALFH = (H + 1) / 2;
+
+                auto&     image       = next.emplace_back(std::make_unique<SLoadedCursorImage>());
+                image->artificial     = true;
+                image->side           = (f->side + 1) / 2;
+                image->delay          = f->delay;
+                image->artificialData = new char[static_cast<unsigned long>(HALFW * HALFH * 4)];
+                image->cairoSurface   = cairo_image_surface_create_for_data((unsigned char*)image->artificialData, CAIRO_FORMAT_ARGB32, HALFW, HALFH, HALFW * 4);
+
+                cairo_surface_flush(f->cairoSurface);
+                Resample::resample(cairo_image_surface_get_data(f->cairoSurface), W, H, cairo_image_surface_get_stride(f->cairoSurface), (uint8_t*)image->artificialData,
+                                   HALFW, HALFH, HALFW * 4, HC_RESIZE_BOX);
+                cairo_surface_mark_dirty(image->cairoSurface);
+            }
+
+            Debug::log(HC_LOG_TRACE, logFn, "getMipFramesFor: built level {} of {}, {}px", i + 1, shape->directory, next.front()->side);
+        }
+
+        level.clear();
+        for (auto& image : loadedShape.mips[i]) {
+            level.push_back(image.get());
+        }
+    }
+
+    return level;
+}
+
+std::vector<SLoadedCursorImage*> CHyprcursorImplementation::getFramesFor(SCursorShape* shape, int size) {
+    std::vector<SLoadedCursorImage*> frames;
+
+    ensureShapeLoaded(shape);
+
+    for (auto& image : loadedShapes.at(shape).images) {
+        if (!image->isSVG && image->side != size)
+            continue;
+
+        if (image->artificial)
+            continue;
+
+        if (!ensureImageDecoded(image.get()))
             continue;
 
         frames.push_back(image.get());
@@ -37,6 +37,51 @@ struct SCursorImageData** hyprcursor_get_cursor_image_data(struct hyprcursor_man
     return data;
 }
 
+hyprcursor_cursor_image_data_view hyprcursor_get_cursor_image_data_view(struct hyprcursor_manager_t* manager, const char* shape, struct hyprcursor_cursor_style_info info_) {
+    const auto       MGR = (CHyprcursorManager*)manager;
+    SCursorStyleInfo info;
+    info.size = info_.size;
+    return MGR->getShapeViewC(shape, info);
+}
+
+hyprcursor_cursor_image_data_batch* hyprcursor_get_cursor_image_data_batch(struct hyprcursor_manager_t* manager, const char* const* shapes, unsigned long int len,
+                                                                           struct hyprcursor_cursor_style_info info_) {
+    const auto       MGR = (CHyprcursorManager*)manager;
+    SCursorStyleInfo info;
+    info.size = info_.size;
+    return MGR->getShapesBatchC(shapes, len, info);
+}
+
+hyprcursor_cursor_image_data_batch* hyprcursor_get_cursor_image_data_batch_for_handles(struct hyprcursor_manager_t* manager, const unsigned int* handles, unsigned long int len,
+                                                                                       struct hyprcursor_cursor_style_info info_) {
+    const auto       MGR = (CHyprcursorManager*)manager;
+    SCursorStyleInfo info;
+    info.size = info_.size;
+    return MGR->getShapesBatchForHandlesC(handles, len, info);
+}
+
+void hyprcursor_cursor_image_data_batch_free(hyprcursor_cursor_image_data_batch* batch) {
+    free(batch);
+}
+
+unsigned int hyprcursor_get_shape_handle(struct hyprcursor_manager_t* manager, const char* shape) {
+    const auto MGR = (CHyprcursorManager*)manager;
+    return MGR->getShapeHandle(shape);
+}
+
+unsigned int hyprcursor_get_cursor_shape_v1_handle(struct hyprcursor_manager_t* manager, uint32_t shape) {
+    const auto MGR = (CHyprcursorManager*)manager;
+    return MGR->getCursorShapeV1Handle(shape);
+}
+
+hyprcursor_cursor_image_data_view hyprcursor_get_cursor_image_data_view_for_handle(struct hyprcursor_manager_t* manager, unsigned int handle,
+                                                                                   struct hyprcursor_cursor_style_info info_) {
+    const auto       MGR = (CHyprcursorManager*)manager;
+    SCursorStyleInfo info;
+    info.size = info_.size;
+    return MGR->getShapeViewForHandleC(handle, info);
+}
+
 void hyprcursor_cursor_image_data_free(hyprcursor_cursor_image_data** data, int size) {
     for (int i = 0; i < size; ++i) {
         free(data[i]);
@@ -72,3 +117,88 @@ CAPI void hyprcursor_raw_shape_data_free(hyprcursor_cursor_raw_shape_data* data)
     delete[] data->images;
     delete data;
 }
+
+CAPI hyprcursor_theme_list* hyprcursor_get_themes(PHYPRCURSORLOGFUNC fn) {
+    return getThemesC(fn);
+}
+
+CAPI void hyprcursor_theme_list_free(hyprcursor_theme_list* list) {
+    freeThemesC(list);
+}
+
+CAPI int hyprcursor_manager_watch_theme_changes(struct hyprcursor_manager_t* manager) {
+    const auto MGR = (CHyprcursorManager*)manager;
+    return MGR->watchThemeChanges();
+}
+
+CAPI unsigned int hyprcursor_manager_dispatch_theme_changes(struct hyprcursor_manager_t* manager) {
+    const auto MGR = (CHyprcursorManager*)manager;
+    return MGR->dispatchThemeChanges();
+}
+
+CAPI int hyprcursor_manager_reload_theme(struct hyprcursor_manager_t* manager) {
+    const auto MGR = (CHyprcursorManager*)manager;
+    return MGR->reloadTheme();
+}
+
+CAPI void hyprcursor_manager_trim_decoded_surfaces(struct hyprcursor_manager_t* manager) {
+    const auto MGR = (CHyprcursorManager*)manager;
+    MGR->trimDecodedSurfaces();
+}
+
+CAPI hyprcursor_style* hyprcursor_style_acquire(struct hyprcursor_manager_t* manager, struct hyprcursor_cursor_style_info info_, float scale) {
+    const auto       MGR = (CHyprcursorManager*)manager;
+    SCursorStyleInfo info;
+    info.size = info_.size;
+    return MGR->acquireStyle(info, scale);
+}
+
+CAPI unsigned int hyprcursor_style_pixel_size(struct hyprcursor_cursor_style_info info_, float scale) {
+    SCursorStyleInfo info;
+    info.size = info_.size;
+    return CHyprcursorManager::getStylePixelSize(info, scale);
+}
+
+CAPI struct hyprcursor_cursor_style_info hyprcursor_style_get_info(struct hyprcursor_manager_t* manager, hyprcursor_style* style) {
+    const auto MGR  = (CHyprcursorManager*)manager;
+    const auto INFO = MGR->getStyleInfo(style);
+    return hyprcursor_cursor_style_info{.size = INFO.size};
+}
+
+CAPI void hyprcursor_style_release(struct hyprcursor_manager_t* manager, hyprcursor_style* style) {
+    const auto MGR = (CHyprcursorManager*)manager;
+    MGR->releaseStyle(style);
+}
+
+CAPI hyprcursor_cursor_image_data_view hyprcursor_style_get_cursor_image_data_view(struct hyprcursor_manager_t* manager, hyprcursor_style* style, const char* shape) {
+    const auto MGR = (CHyprcursorManager*)manager;
+    return MGR->getStyleShapeViewC(style, shape);
+}
+
+CAPI hyprcursor_cursor_image_data_view hyprcursor_style_get_cursor_image_data_view_for_handle(struct hyprcursor_manager_t* manager, hyprcursor_style* style,
+                                                                                              unsigned int handle) {
+    const auto MGR = (CHyprcursorManager*)manager;
+    return MGR->getStyleShapeViewForHandleC(style, handle);
+}
+
+CAPI hyprcursor_style* hyprcursor_style_acquire_async(struct hyprcursor_manager_t* manager, struct hyprcursor_cursor_style_info info_, float scale) {
+    const auto       MGR = (CHyprcursorManager*)manager;
+    SCursorStyleInfo info;
+    info.size = info_.size;
+    return MGR->acquireStyleAsync(info, scale);
+}
+
+CAPI int hyprcursor_manager_watch_style_loads(struct hyprcursor_manager_t* manager) {
+    const auto MGR = (CHyprcursorManager*)manager;
+    return MGR->watchStyleLoads();
+}
+
+CAPI unsigned int hyprcursor_manager_dispatch_style_loads(struct hyprcursor_manager_t* manager) {
+    const auto MGR = (CHyprcursorManager*)manager;
+    return MGR->dispatchStyleLoads();
+}
+
+CAPI int hyprcursor_style_loading(struct hyprcursor_manager_t* manager, hyprcursor_style* style) {
+    const auto MGR = (CHyprcursorManager*)manager;
+    return MGR->styleLoading(style);
+}
@@ -1,19 +1,44 @@
 #pragma once
 
 #include "internalSharedTypes.hpp"
+#include "mappedArchive.hpp"
+#include "themePack.hpp"
+#include "shapeIndex.hpp"
+#include "cursorShapes.hpp"
+#include "themeWatcher.hpp"
+#include "hyprcursor/hyprcursor.hpp"
 #include <optional>
 #include <cairo/cairo.h>
+#include <librsvg/rsvg.h>
 #include <unordered_map>
+#include <unordered_set>
+#include <span>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <shared_mutex>
+#include <condition_variable>
+#include <deque>
+#include <array>
 #include <memory>
+#include <filesystem>
+#include <zip.h>
+
+// recordings are made at this size and scaled when replayed. Only matters for what librsvg rasterizes itself, like filters.
+constexpr int SVG_RECORDING_SIDE = 256;
 
 struct SLoadedCursorImage {
     ~SLoadedCursorImage() {
-        if (data)
+        if (data && dataOwned)
             delete[] (char*)data;
         if (artificialData)
             delete[] (char*)artificialData;
         if (cairoSurface)
             cairo_surface_destroy(cairoSurface);
+        if (svgHandle)
+            g_object_unref(svgHandle);
+        if (svgRecording)
+            cairo_surface_destroy(svgRecording);
     }
 
     // read stuff
@@ -21,18 +46,107 @@ struct SLoadedCursorImage {
     void*            data       = nullptr; // raw png / svg data, not image data
     size_t           dataLen    = 0;
     bool             isSVG      = false; // if true, data is just a string of chars
+    bool             dataOwned  = true;  // false if data points into a mapped archive
 
     cairo_surface_t* cairoSurface = nullptr;
     int              side         = 0;
     int              delay        = 0;
 
+    // parsed svg, reused for every size. A handle can't render on two threads at once.
+    RsvgHandle*      svgHandle = nullptr;
+    // or the svg rendered into a recording surface at SVG_RECORDING_SIDE, replaces svgHandle
+    cairo_surface_t* svgRecording = nullptr;
+    std::mutex       svgMutex;
+
     // means this was created by resampling
     void* artificialData = nullptr;
     bool  artificial     = false;
 };
 
+/*
+    A loaded style: the frames resampled for it, and the views handed out for it.
+    Shapes the style has no frames for use the theme's images.
+*/
+struct SCursorStyleC {
+    Hyprcursor::SCursorStyleInfo                                                         info;
+    unsigned int                                                                         refs = 0;
+
+    // shapes already rasterized, or found to not need it
+    std::unordered_set<SCursorShape*>                                                    rendered;
+
+    // set while the style renders in the background, see acquireStyleAsync.
+    // pending shapes have frames on the way, and meanwhile get the nearest size there is.
+    bool                                                                                 loading = false;
+    std::unordered_set<SCursorShape*>                                                    pending;
+
+    // shared, so a pending shape's view can borrow another style's frames and keep them alive past its release
+    std::unordered_map<SCursorShape*, std::vector<std::shared_ptr<SLoadedCursorImage>>> frames;
+    std::unordered_map<SCursorShape*, std::vector<std::shared_ptr<SLoadedCursorImage>>> borrowed;
+    std::unordered_map<SCursorShape*, std::vector<SCursorImageData>>                    views;
+};
+
+// one frame to rasterize for a style
+struct SStyleRenderJob {
+    SCursorShape*                       shape  = nullptr;
+    SLoadedCursorImage*                 source = nullptr;
+    int                                 side   = 0;
+    std::unique_ptr<SLoadedCursorImage> image;
+};
+
+// a style loading in the background. The loader never touches the style, only the batches' jobs and results.
+struct SStyleLoad {
+    SCursorStyleC* style = nullptr; // nullptr once cancelled
+    unsigned int   size  = 0;       // the style's
+
+    struct SBatch {
+        std::vector<SCursorShape*>              shapes;
+        std::vector<SStyleRenderJob>            jobs;
+        std::vector<std::optional<std::string>> results;
+    };
+
+    // commonly used shapes, then the rest. The first is committed as soon as it's rendered.
+    std::array<SBatch, 2> batches;
+
+    enum eStage : uint8_t {
+        STAGE_RENDERING = 0,
+        STAGE_PRIORITY_DONE,
+        STAGE_DONE,
+    };
+
+    std::atomic<bool>     cancelled      = false;
+    std::atomic<eStage>   stage          = STAGE_RENDERING;
+    eStage                committedStage = STAGE_RENDERING;
+};
+
+struct SShapeViewKey {
+    SCursorShape* shape = nullptr;
+    unsigned int  size  = 0;
+
+    bool          operator==(const SShapeViewKey&) const = default;
+};
+
+struct SShapeViewKeyHash {
+    size_t operator()(const SShapeViewKey& k) const {
+        return std::hash<SCursorShape*>{}(k.shape) ^ ((size_t)k.size * 0x9E3779B97F4A7C15ULL);
+    }
+};
+
 struct SLoadedCursorShape {
+    // kept alive while images point into it, so declared before them
+    std::shared_ptr<CMappedArchive>                  archive;
+
     std::vector<std::unique_ptr<SLoadedCursorImage>> images;
+
+    // halvings of the largest size's frames, built as styles need them
+    std::vector<std::vector<std::unique_ptr<SLoadedCursorImage>>> mips;
+
+    std::string                                      archivePath;
+    bool                                             loaded    = false; // images were read, or at least attempted to
+    uint32_t                                         packShape = 0;     // index in the pack, if the theme was loaded from one
+
+    // the style loader works on shapes while the caller can too. Loading, decoding and planning take this exclusively,
+    // rendering from the images shared.
+    std::shared_mutex                                mutex;
 };
 
 class CHyprcursorImplementation {
@@ -40,19 +154,117 @@ class CHyprcursorImplementation {
     CHyprcursorImplementation(Hyprcursor::CHyprcursorManager* mgr, PHYPRCURSORLOGFUNC fn) : owner(mgr), logFn(fn) {
         ;
     }
+    ~CHyprcursorImplementation();
+
+    // takes over what the manager keeps across reloads from the implementation this one replaces
+    void takeManagerState(CHyprcursorImplementation& other);
 
     Hyprcursor::CHyprcursorManager* owner = nullptr;
     PHYPRCURSORLOGFUNC              logFn = nullptr;
 
     std::string                     themeName;
     std::string                     themeFullDir;
+    std::string                     themeCursorsDir;
+
+    // the manager's options and state. reloadTheme replaces the implementation and moves these over, see takeManagerState.
+    std::string                     requestedThemeName;
+    bool                            lazy            = false;
+    unsigned int                    loadThreads     = 1;
+    bool                            decodeOnDemand  = false;
+    bool                            lazyStyles      = false;
+    bool                            mipmaps         = false;
+    bool                            svgDisplayLists = false;
+    std::unique_ptr<CThemeWatcher>  watcher;
+
+    // set if the theme was loaded from a pack, images point into it
+    std::shared_ptr<CThemePack>     pack;
 
     SCursorTheme                    theme;
 
     //
     std::unordered_map<SCursorShape*, SLoadedCursorShape> loadedShapes;
 
+    // names and overrides to shapes, built once the theme is loaded
+    CShapeIndex shapeIndex;
+
+    // resolved images per shape and style size, handed out by getShapeView
+    std::unordered_map<SShapeViewKey, std::vector<SCursorImageData>, SShapeViewKeyHash> shapeViews;
+
+    // loaded styles by size, see CHyprcursorManager::acquireStyle
+    std::unordered_map<unsigned int, std::unique_ptr<SCursorStyleC>> styles;
+
+    // styles loading in the background, and the eventfd they signal. The manager closes it, it outlives reloads.
+    std::vector<std::unique_ptr<SStyleLoad>> styleLoads;
+    int                                      styleLoadFD = -1;
+
+    // one thread runs queued loads in order, started with the first
+    std::thread                              styleLoader;
+    std::mutex                               styleLoaderMutex;
+    std::condition_variable                  styleLoaderCV; // new loads, and loads done
+    std::deque<SStyleLoad*>                  styleLoadQueue;
+    bool                                     styleLoaderExit = false;
+
+    // raw image views per shape, handed out by getRawShapeDataView
+    std::unordered_map<SCursorShape*, std::vector<Hyprcursor::SCursorRawShapeImageView>> rawViews;
+
+    // handle for every wp_cursor_shape_device_v1 shape, 0 if the theme has none
+    std::array<unsigned int, CursorShapes::SHAPE_COUNT> cursorShapeHandles{};
+
     //
     std::optional<std::string>       loadTheme();
     std::vector<SLoadedCursorImage*> getFramesFor(SCursorShape* shape, int size);
+    // frames of the smallest mip level at least side big, building levels as needed. Empty if the shape can't have mips.
+    std::vector<SLoadedCursorImage*> getMipFramesFor(SCursorShape* shape, int side);
+
+    // returns the cached images of shape for a style, resolving them if needed, or nullptr on error
+    const std::vector<SCursorImageData>* getShapeView(SCursorShape* shape, const Hyprcursor::SCursorStyleInfo& info);
+    const std::vector<SCursorImageData>* getStyleShapeView(SCursorStyleC* style, SCursorShape* shape);
+    // queues a style's shapes, commonly used ones first, to be read, decoded and rendered by the style loader
+    std::optional<std::string> startStyleLoad(SCursorStyleC* style);
+    // commits what background loads rendered so far, returns how many styles finished
+    unsigned int dispatchStyleLoads();
+    // waits for background loads, of one style or all, and commits them
+    void finishStyleLoads(SCursorStyleC* style = nullptr);
+    // stops rendering a style, the load is reaped later
+    void cancelStyleLoad(SCursorStyleC* style);
+
+    // rasterizes shapes' frames for a style on loadThreads threads, each shape once. Shapes with a native image at the size get none.
+    // frames are only added to the style if all of them rendered.
+    std::optional<std::string> renderStyleShapes(SCursorStyleC* style, std::span<SCursorShape* const> shapes);
+    void                                 buildCursorShapeHandles();
+    // drops cached views for a style size
+    void dropShapeViews(unsigned int size);
+
+    // reads the shape's images if that wasn't done at load time, returns false if it has none
+    bool ensureShapeLoaded(SCursorShape* shape);
+
+    // decodes a png image if it isn't already, returns false if that failed
+    bool ensureImageDecoded(SLoadedCursorImage* image);
+
+    // parses an svg image if it isn't already
+    std::optional<std::string> ensureSvgParsed(SLoadedCursorImage* image);
+    // records an svg image into a display list if it isn't already
+    std::optional<std::string> ensureSvgRecorded(SLoadedCursorImage* image);
+
+  private:
+    // stamp is the cursors directory's CThemePack::sourceStamp, 0 to accept the pack regardless
+    bool                       loadThemePack(const std::string& path, uint64_t stamp);
+    std::optional<std::string> loadPackShapeImages(SCursorShape* shape, SLoadedCursorShape& loadedShape);
+    zip_t*                     openShapeArchive(SLoadedCursorShape& loadedShape);
+    void                       closeShapeArchive(zip_t* zip, SLoadedCursorShape& loadedShape);
+    std::optional<std::string> loadShapeArchive(const std::filesystem::path& path, SCursorShape* shape, SLoadedCursorShape& loadedShape);
+    std::optional<std::string> loadShapeMeta(zip_t* zip, const std::filesystem::path& path, SCursorShape* shape);
+    std::optional<std::string> loadShapeImages(zip_t* zip, SCursorShape* shape, SLoadedCursorShape& loadedShape);
+    std::optional<std::string> readImageFromZip(zip_t* zip, const std::string& name, SLoadedCursorImage* image);
+    std::optional<std::string> decodeImage(SLoadedCursorImage* image);
+    // adds the frames shape needs rendered at a style size to jobs. Callers hold the shape's mutex.
+    std::optional<std::string> planShapeFrames(SCursorShape* shape, unsigned int size, std::vector<SStyleRenderJob>& jobs);
+    void                       renderStyleJobs(std::span<SStyleRenderJob> jobs, std::span<std::optional<std::string>> results, const std::atomic<bool>* cancelled);
+    void                       styleLoaderMain();
+    void                       runStyleLoad(SStyleLoad& load);
+    void                       commitStyleBatch(SStyleLoad& load, SStyleLoad::SBatch& batch);
+    // commits what's left of a finished load
+    void                       commitStyleLoad(SStyleLoad& load);
+    bool                       resolveFallbackImages(SCursorStyleC* style, SCursorShape* shape, std::vector<SLoadedCursorImage*>& resultingImages);
+    bool                       resolveNativeImages(SCursorShape* shape, const Hyprcursor::SCursorStyleInfo& info, std::vector<SLoadedCursorImage*>& resultingImages);
 };
\ No newline at end of file
@@ -15,6 +15,10 @@ inline eHyprcursorResizeAlgo stringToAlgo(const std::string& s) {
         return HC_RESIZE_NONE;
     if (s == "nearest")
         return HC_RESIZE_NEAREST;
+    if (s == "box")
+        return HC_RESIZE_BOX;
+    if (s == "lanczos")
+        return HC_RESIZE_LANCZOS;
     return HC_RESIZE_BILINEAR;
 }
 
@@ -22,6 +26,8 @@ inline std::string algoToString(const eHyprcursorResizeAlgo a) {
     switch (a) {
         case HC_RESIZE_BILINEAR: return "bilinear";
         case HC_RESIZE_NEAREST: return "nearest";
+        case HC_RESIZE_BOX: return "box";
+        case HC_RESIZE_LANCZOS: return "lanczos";
         case HC_RESIZE_NONE: return "none";
         default: return "none";
     }
@@ -0,0 +1,124 @@
+#include "mappedArchive.hpp"
+
+#include <algorithm>
+
+constexpr uint32_t LOCAL_HEADER_SIG   = 0x04034b50;
+constexpr uint32_t CENTRAL_HEADER_SIG = 0x02014b50;
+constexpr uint32_t EOCD_SIG           = 0x06054b50;
+constexpr size_t   LOCAL_HEADER_LEN   = 30;
+constexpr size_t   CENTRAL_HEADER_LEN = 46;
+constexpr size_t   EOCD_LEN           = 22;
+
+static uint16_t    read16(const uint8_t* p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t read32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+CMappedArchive::CMappedArchive(const std::string& path) : file(path) {
+    mapping     = file.data();
+    mappingSize = file.size();
+
+    if (mappingSize < EOCD_LEN)
+        return;
+
+    parseCentralDirectory();
+}
+
+bool CMappedArchive::good() {
+    return file.good() && mappingSize >= EOCD_LEN;
+}
+
+void CMappedArchive::parseCentralDirectory() {
+    // the EOCD record is at the end, followed by a comment of up to 64k
+    const size_t SEARCHEND = mappingSize - EOCD_LEN;
+    const size_t SEARCHMIN = SEARCHEND > 0xFFFF ? SEARCHEND - 0xFFFF : 0;
+
+    size_t       eocd = SIZE_MAX;
+    for (size_t i = SEARCHEND + 1; i-- > SEARCHMIN;) {
+        if (read32(mapping + i) == EOCD_SIG) {
+            eocd = i;
+            break;
+        }
+    }
+
+    // no EOCD, or a zip64 archive. Not worth handling for cursors, libzip can still read those.
+    if (eocd == SIZE_MAX)
+        return;
+
+    const uint16_t ENTRIES  = read16(mapping + eocd + 10);
+    const uint32_t CDOFFSET = read32(mapping + eocd + 16);
+
+    size_t         offset = CDOFFSET;
+    for (uint16_t i = 0; i < ENTRIES; ++i) {
+        if (offset + CENTRAL_HEADER_LEN > mappingSize || read32(mapping + offset) != CENTRAL_HEADER_SIG)
+            return;
+
+        const uint8_t* HEADER     = mapping + offset;
+        const uint16_t FLAGS      = read16(HEADER + 8);
+        const uint16_t METHOD     = read16(HEADER + 10);
+        const uint32_t COMPSIZE   = read32(HEADER + 20);
+        const uint32_t SIZE       = read32(HEADER + 24);
+        const uint16_t NAMELEN    = read16(HEADER + 28);
+        const uint16_t EXTRALEN   = read16(HEADER + 30);
+        const uint16_t COMMENTLEN = read16(HEADER + 32);
+        const uint32_t LOCALOFF   = read32(HEADER + 42);
+
+        if (offset + CENTRAL_HEADER_LEN + NAMELEN > mappingSize)
+            return;
+
+        const std::string NAME{(const char*)HEADER + CENTRAL_HEADER_LEN, NAMELEN};
+        offset += CENTRAL_HEADER_LEN + NAMELEN + EXTRALEN + COMMENTLEN;
+
+        SEntry entry;
+
+        // only plain stored entries can be used in place, the rest is left to libzip
+        entry.stored = METHOD == ZIP_CM_STORE && !(FLAGS & 1) && COMPSIZE == SIZE && SIZE != 0xFFFFFFFF && LOCALOFF != 0xFFFFFFFF;
+
+        if (entry.stored) {
+            if ((size_t)LOCALOFF + LOCAL_HEADER_LEN > mappingSize || read32(mapping + LOCALOFF) != LOCAL_HEADER_SIG)
+                continue;
+
+            // the local header can have a different extra field than the central one
+            entry.dataOffset = (size_t)LOCALOFF + LOCAL_HEADER_LEN + read16(mapping + LOCALOFF + 26) + read16(mapping + LOCALOFF + 28);
+            entry.size       = SIZE;
+
+            if (entry.dataOffset + entry.size > mappingSize)
+                continue;
+        }
+
+        entries.emplace(NAME, entry);
+    }
+}
+
+std::span<const uint8_t> CMappedArchive::storedEntry(const std::string& name) {
+    const auto IT = entries.find(name);
+    if (IT == entries.end() || !IT->second.stored)
+        return {};
+
+    return {mapping + IT->second.dataOffset, IT->second.size};
+}
+
+zip_t* CMappedArchive::openZip() {
+    if (!good())
+        return nullptr;
+
+    zip_error_t error;
+    zip_error_init(&error);
+
+    zip_source_t* source = zip_source_buffer_create(mapping, mappingSize, 0, &error);
+    if (!source) {
+        zip_error_fini(&error);
+        return nullptr;
+    }
+
+    zip_t* zip = zip_open_from_source(source, ZIP_RDONLY, &error);
+    if (!zip)
+        zip_source_free(source);
+
+    zip_error_fini(&error);
+
+    return zip;
+}
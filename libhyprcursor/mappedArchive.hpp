@@ -0,0 +1,51 @@
+#pragma once
+
+#include <string>
+#include <span>
+#include <cstdint>
+#include <unordered_map>
+#include <zip.h>
+
+#include "mappedFile.hpp"
+
+/*
+    A read-only mmap of a zip archive (.hlc).
+
+    Entries stored without compression can be accessed in place, everything
+    else goes through libzip, which then reads from the mapping as well.
+*/
+class CMappedArchive {
+  public:
+    CMappedArchive(const std::string& path);
+
+    CMappedArchive(const CMappedArchive&)            = delete;
+    CMappedArchive& operator=(const CMappedArchive&) = delete;
+
+    bool            good();
+
+    /*
+        Returns the bytes of an entry stored uncompressed, or an empty span
+        if the entry is missing or compressed.
+    */
+    std::span<const uint8_t> storedEntry(const std::string& name);
+
+    /*
+        Opens the mapping with libzip, or returns nullptr.
+        The mapping must outlive the returned handle.
+    */
+    zip_t* openZip();
+
+  private:
+    struct SEntry {
+        uint64_t dataOffset = 0;
+        uint32_t size       = 0;
+        bool     stored     = false;
+    };
+
+    void                                    parseCentralDirectory();
+
+    CMappedFile                             file;
+    std::unordered_map<std::string, SEntry> entries;
+    const uint8_t*                          mapping     = nullptr;
+    size_t                                  mappingSize = 0;
+};
@@ -0,0 +1,44 @@
+#include "mappedFile.hpp"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+CMappedFile::CMappedFile(const std::string& path) {
+    const int FD = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (FD < 0)
+        return;
+
+    struct stat st;
+    if (fstat(FD, &st) != 0 || st.st_size <= 0) {
+        close(FD);
+        return;
+    }
+
+    void* map = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, FD, 0);
+    close(FD);
+
+    if (map == MAP_FAILED)
+        return;
+
+    mapping     = (uint8_t*)map;
+    mappingSize = st.st_size;
+}
+
+CMappedFile::~CMappedFile() {
+    if (mapping)
+        munmap(mapping, mappingSize);
+}
+
+bool CMappedFile::good() {
+    return mapping;
+}
+
+const uint8_t* CMappedFile::data() {
+    return mapping;
+}
+
+size_t CMappedFile::size() {
+    return mappingSize;
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+/*
+    A read-only, private mmap of a whole file.
+*/
+class CMappedFile {
+  public:
+    CMappedFile(const std::string& path);
+    ~CMappedFile();
+
+    CMappedFile(const CMappedFile&)            = delete;
+    CMappedFile& operator=(const CMappedFile&) = delete;
+
+    bool           good();
+
+    const uint8_t* data();
+    size_t         size();
+
+  private:
+    uint8_t* mapping     = nullptr;
+    size_t   mappingSize = 0;
+};
@@ -8,23 +8,26 @@
 
 #include "VarList.hpp"
 
-static CMeta* currentMeta = nullptr;
+// metas can be parsed on several threads at once
+static thread_local CMeta* currentMeta = nullptr;
 
-CMeta::CMeta(const std::string& rawdata_, bool hyprlang_ /* false for toml */, bool dataIsPath) : dataPath(dataIsPath), hyprlang(hyprlang_), rawdata(rawdata_) {
+CMeta::CMeta(std::string_view rawdata_, bool hyprlang_ /* false for toml */, bool dataIsPath) : dataPath(dataIsPath), hyprlang(hyprlang_), rawdata(rawdata_) {
     if (!dataIsPath)
         return;
 
+    const std::string PATH{rawdata_};
+
     rawdata = "";
 
     try {
-        if (std::filesystem::exists(rawdata_ + ".hl")) {
-            rawdata  = rawdata_ + ".hl";
+        if (std::filesystem::exists(PATH + ".hl")) {
+            rawdata  = PATH + ".hl";
             hyprlang = true;
             return;
         }
 
-        if (std::filesystem::exists(rawdata_ + ".toml")) {
-            rawdata  = rawdata_ + ".toml";
+        if (std::filesystem::exists(PATH + ".toml")) {
+            rawdata  = PATH + ".toml";
             hyprlang = false;
             return;
         }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <optional>
 #include <vector>
 
@@ -9,7 +10,7 @@
 */
 class CMeta {
   public:
-    CMeta(const std::string& rawdata_, bool hyprlang_ /* false for toml */, bool dataIsPath = false);
+    CMeta(std::string_view rawdata_, bool hyprlang_ /* false for toml */, bool dataIsPath = false);
 
     std::optional<std::string> parse();
 
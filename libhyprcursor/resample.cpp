@@ -0,0 +1,522 @@
+#include "resample.hpp"
+
+#include <vector>
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+#include <atomic>
+#include <string_view>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define RESAMPLE_X86
+#elif defined(__ARM_NEON) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#include <arm_neon.h>
+#define RESAMPLE_NEON
+#endif
+
+// weights are fixed point, and have to fit an int16 for the simd kernels
+constexpr int PRECISION = 14;
+constexpr int ONE       = 1 << PRECISION;
+constexpr int ROUND     = 1 << (PRECISION - 1);
+
+// weights of every output pixel along one axis
+struct SKernel {
+    std::vector<int>     start, taps;
+    std::vector<int16_t> weights; // maxTaps per output pixel
+    int                  maxTaps = 0;
+
+    const int16_t*       weightsFor(int i) const {
+        return weights.data() + (size_t)i * maxTaps;
+    }
+};
+
+static double filterBox(double x) {
+    return x > -0.5 && x <= 0.5 ? 1.0 : 0.0;
+}
+
+static double filterTriangle(double x) {
+    x = std::abs(x);
+    return x < 1.0 ? 1.0 - x : 0.0;
+}
+
+static double sinc(double x) {
+    if (x == 0.0)
+        return 1.0;
+
+    x *= M_PI;
+    return std::sin(x) / x;
+}
+
+static double filterLanczos(double x) {
+    return x > -3.0 && x < 3.0 ? sinc(x) * sinc(x / 3.0) : 0.0;
+}
+
+static SKernel makeKernel(int srcSize, int dstSize, double (*filter)(double), double support) {
+    SKernel      kernel;
+
+    const double SCALE = (double)srcSize / dstSize;
+    // when reducing, the filter is stretched to cover every source pixel
+    const double FILTERSCALE = std::max(SCALE, 1.0);
+    const double SUPPORT     = support * FILTERSCALE;
+
+    kernel.maxTaps = (int)std::ceil(SUPPORT) * 2 + 1;
+    kernel.start.resize(dstSize);
+    kernel.taps.resize(dstSize);
+    kernel.weights.resize((size_t)dstSize * kernel.maxTaps, 0);
+
+    std::vector<double> w(kernel.maxTaps);
+
+    for (int i = 0; i < dstSize; ++i) {
+        const double CENTER = (i + 0.5) * SCALE;
+        int          first  = std::max(0, (int)std::floor(CENTER - SUPPORT + 0.5));
+        int          taps   = std::min(srcSize, (int)std::floor(CENTER + SUPPORT + 0.5)) - first;
+        taps                = std::clamp(taps, 1, kernel.maxTaps);
+
+        double sum = 0;
+        for (int k = 0; k < taps; ++k) {
+            w[k] = filter((first + k - CENTER + 0.5) / FILTERSCALE);
+            sum += w[k];
+        }
+
+        auto out = kernel.weights.data() + (size_t)i * kernel.maxTaps;
+
+        if (sum == 0.0) {
+            // can't happen with our filters, but take the nearest pixel rather than nothing
+            kernel.start[i] = std::min(srcSize - 1, (int)CENTER);
+            kernel.taps[i]  = 1;
+            out[0]          = ONE;
+            continue;
+        }
+
+        // rounding errors go on the largest weight, so flat areas stay flat
+        int total = 0, largest = 0;
+        for (int k = 0; k < taps; ++k) {
+            out[k] = (int16_t)std::lround(w[k] / sum * ONE);
+            total += out[k];
+
+            if (out[k] > out[largest])
+                largest = k;
+        }
+
+        out[largest] += ONE - total;
+
+        // zero weights at the edges would only cost loads
+        int lead = 0;
+        while (lead < taps - 1 && out[lead] == 0) {
+            lead++;
+        }
+
+        while (taps > lead + 1 && out[taps - 1] == 0) {
+            taps--;
+        }
+
+        if (lead > 0)
+            std::copy(out + lead, out + taps, out);
+
+        std::fill(out + taps - lead, out + kernel.maxTaps, 0);
+
+        kernel.start[i] = first + lead;
+        kernel.taps[i]  = taps - lead;
+    }
+
+    return kernel;
+}
+
+static uint32_t clampToAlpha(uint32_t px) {
+    // overshooting filters can make a channel exceed alpha, which premultiplied color can't
+    const uint32_t A = px >> 24;
+    uint32_t       result = px & 0xFF000000;
+
+    for (int shift = 0; shift < 24; shift += 8) {
+        result |= std::min((px >> shift) & 0xFF, A) << shift;
+    }
+
+    return result;
+}
+
+static uint32_t packScalar(const int32_t acc[4]) {
+    uint32_t px = 0;
+
+    for (int c = 0; c < 4; ++c) {
+        px |= (uint32_t)std::clamp(acc[c] >> PRECISION, 0, 255) << (c * 8);
+    }
+
+    return clampToAlpha(px);
+}
+
+static void horizontalScalar(const uint32_t* src, uint32_t* dst, int width, const SKernel& kernel) {
+    for (int x = 0; x < width; ++x) {
+        const auto     W     = kernel.weightsFor(x);
+        const auto     ROW   = src + kernel.start[x];
+        int32_t        acc[4] = {ROUND, ROUND, ROUND, ROUND};
+
+        for (int k = 0; k < kernel.taps[x]; ++k) {
+            for (int c = 0; c < 4; ++c) {
+                acc[c] += (int32_t)((ROW[k] >> (c * 8)) & 0xFF) * W[k];
+            }
+        }
+
+        dst[x] = packScalar(acc);
+    }
+}
+
+// also finishes the columns simd kernels leave over
+static void verticalTail(const uint8_t* src, size_t stride, uint32_t* dst, int from, int width, int start, int taps, const int16_t* weights) {
+    for (int x = from; x < width; ++x) {
+        int32_t acc[4] = {ROUND, ROUND, ROUND, ROUND};
+
+        for (int k = 0; k < taps; ++k) {
+            const uint32_t PX = ((const uint32_t*)(src + (start + k) * stride))[x];
+
+            for (int c = 0; c < 4; ++c) {
+                acc[c] += (int32_t)((PX >> (c * 8)) & 0xFF) * weights[k];
+            }
+        }
+
+        dst[x] = packScalar(acc);
+    }
+}
+
+static void verticalScalar(const uint8_t* src, size_t stride, uint32_t* dst, int width, int start, int taps, const int16_t* weights) {
+    verticalTail(src, stride, dst, 0, width, start, taps, weights);
+}
+
+#ifdef RESAMPLE_X86
+
+// weights for two taps, interleaved like the pixels madd sees
+static int32_t weightPair(int16_t w0, int16_t w1) {
+    return (int32_t)((uint32_t)(uint16_t)w0 | ((uint32_t)(uint16_t)w1 << 16));
+}
+
+static __m128i clampToAlphaSSE2(__m128i px) {
+    const __m128i A = _mm_srli_epi32(px, 24);
+    __m128i       t = _mm_or_si128(A, _mm_slli_epi32(A, 8));
+    t               = _mm_or_si128(t, _mm_slli_epi32(t, 16));
+    return _mm_min_epu8(px, t);
+}
+
+static __m128i horizontalPixelSSE2(const uint32_t* row, int taps, const int16_t* w, __m128i acc) {
+    const __m128i ZERO = _mm_setzero_si128();
+
+    int           k = 0;
+    for (; k + 1 < taps; k += 2) {
+        const __m128i P0 = _mm_cvtsi32_si128((int)row[k]);
+        const __m128i P1 = _mm_cvtsi32_si128((int)row[k + 1]);
+        // c0 of both, c1 of both, ...
+        const __m128i PP = _mm_unpacklo_epi8(_mm_unpacklo_epi8(P0, P1), ZERO);
+        acc              = _mm_add_epi32(acc, _mm_madd_epi16(PP, _mm_set1_epi32(weightPair(w[k], w[k + 1]))));
+    }
+
+    if (k < taps) {
+        const __m128i P0 = _mm_cvtsi32_si128((int)row[k]);
+        const __m128i PP = _mm_unpacklo_epi8(_mm_unpacklo_epi8(P0, ZERO), ZERO);
+        acc              = _mm_add_epi32(acc, _mm_madd_epi16(PP, _mm_set1_epi32(weightPair(w[k], 0))));
+    }
+
+    return acc;
+}
+
+static uint32_t packPixelSSE2(__m128i acc) {
+    acc = _mm_srai_epi32(acc, PRECISION);
+    acc = _mm_packs_epi32(acc, acc);
+    acc = _mm_packus_epi16(acc, acc);
+    return (uint32_t)_mm_cvtsi128_si32(clampToAlphaSSE2(acc));
+}
+
+static void horizontalSSE2(const uint32_t* src, uint32_t* dst, int width, const SKernel& kernel) {
+    for (int x = 0; x < width; ++x) {
+        dst[x] = packPixelSSE2(horizontalPixelSSE2(src + kernel.start[x], kernel.taps[x], kernel.weightsFor(x), _mm_set1_epi32(ROUND)));
+    }
+}
+
+static void verticalSSE2(const uint8_t* src, size_t stride, uint32_t* dst, int width, int start, int taps, const int16_t* weights) {
+    const __m128i ZERO = _mm_setzero_si128();
+
+    int           x = 0;
+    for (; x + 4 <= width; x += 4) {
+        __m128i acc0 = _mm_set1_epi32(ROUND), acc1 = acc0, acc2 = acc0, acc3 = acc0;
+
+        for (int k = 0; k < taps; k += 2) {
+            const bool    PAIR = k + 1 < taps;
+            const __m128i A    = _mm_loadu_si128((const __m128i*)(src + (start + k) * stride + x * 4));
+            const __m128i B    = PAIR ? _mm_loadu_si128((const __m128i*)(src + (start + k + 1) * stride + x * 4)) : ZERO;
+            const __m128i W    = _mm_set1_epi32(weightPair(weights[k], PAIR ? weights[k + 1] : 0));
+
+            const __m128i LO = _mm_unpacklo_epi8(A, B);
+            const __m128i HI = _mm_unpackhi_epi8(A, B);
+
+            acc0 = _mm_add_epi32(acc0, _mm_madd_epi16(_mm_unpacklo_epi8(LO, ZERO), W));
+            acc1 = _mm_add_epi32(acc1, _mm_madd_epi16(_mm_unpackhi_epi8(LO, ZERO), W));
+            acc2 = _mm_add_epi32(acc2, _mm_madd_epi16(_mm_unpacklo_epi8(HI, ZERO), W));
+            acc3 = _mm_add_epi32(acc3, _mm_madd_epi16(_mm_unpackhi_epi8(HI, ZERO), W));
+        }
+
+        const __m128i P01 = _mm_packs_epi32(_mm_srai_epi32(acc0, PRECISION), _mm_srai_epi32(acc1, PRECISION));
+        const __m128i P23 = _mm_packs_epi32(_mm_srai_epi32(acc2, PRECISION), _mm_srai_epi32(acc3, PRECISION));
+
+        _mm_storeu_si128((__m128i*)(dst + x), clampToAlphaSSE2(_mm_packus_epi16(P01, P23)));
+    }
+
+    verticalTail(src, stride, dst, x, width, start, taps, weights);
+}
+
+__attribute__((target("avx2"))) static void horizontalAVX2(const uint32_t* src, uint32_t* dst, int width, const SKernel& kernel) {
+    // gathers c0 of two pixels, then c1, ... in each half
+    const __m128i INTERLEAVE = _mm_setr_epi8(0, 4, 1, 5, 2, 6, 3, 7, 8, 12, 9, 13, 10, 14, 11, 15);
+
+    for (int x = 0; x < width; ++x) {
+        const auto ROW  = src + kernel.start[x];
+        const auto W    = kernel.weightsFor(x);
+        const int  TAPS = kernel.taps[x];
+
+        __m256i    acc = _mm256_setzero_si256();
+
+        int        k = 0;
+        for (; k + 3 < TAPS; k += 4) {
+            const __m256i PX = _mm256_cvtepu8_epi16(_mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(ROW + k)), INTERLEAVE));
+            const __m256i WS = _mm256_setr_epi32(weightPair(W[k], W[k + 1]), weightPair(W[k], W[k + 1]), weightPair(W[k], W[k + 1]), weightPair(W[k], W[k + 1]),
+                                                 weightPair(W[k + 2], W[k + 3]), weightPair(W[k + 2], W[k + 3]), weightPair(W[k + 2], W[k + 3]),
+                                                 weightPair(W[k + 2], W[k + 3]));
+            acc              = _mm256_add_epi32(acc, _mm256_madd_epi16(PX, WS));
+        }
+
+        __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+        sum         = _mm_add_epi32(sum, _mm_set1_epi32(ROUND));
+
+        // the sse2 helpers aren't vex encoded, mixing them with dirty upper halves is very slow
+        _mm256_zeroupper();
+
+        dst[x] = packPixelSSE2(horizontalPixelSSE2(ROW + k, TAPS - k, W + k, sum));
+    }
+}
+
+__attribute__((target("avx2"))) static void verticalAVX2(const uint8_t* src, size_t stride, uint32_t* dst, int width, int start, int taps, const int16_t* weights) {
+    const __m256i ZERO = _mm256_setzero_si256();
+
+    int           x = 0;
+    for (; x + 8 <= width; x += 8) {
+        __m256i acc0 = _mm256_set1_epi32(ROUND), acc1 = acc0, acc2 = acc0, acc3 = acc0;
+
+        for (int k = 0; k < taps; k += 2) {
+            const bool    PAIR = k + 1 < taps;
+            const __m256i A    = _mm256_loadu_si256((const __m256i*)(src + (start + k) * stride + x * 4));
+            const __m256i B    = PAIR ? _mm256_loadu_si256((const __m256i*)(src + (start + k + 1) * stride + x * 4)) : ZERO;
+            const __m256i W    = _mm256_set1_epi32(weightPair(weights[k], PAIR ? weights[k + 1] : 0));
+
+            // unpacks stay within 128 bit lanes, and so do the packs below, which puts pixels back in order
+            const __m256i LO = _mm256_unpacklo_epi8(A, B);
+            const __m256i HI = _mm256_unpackhi_epi8(A, B);
+
+            acc0 = _mm256_add_epi32(acc0, _mm256_madd_epi16(_mm256_unpacklo_epi8(LO, ZERO), W));
+            acc1 = _mm256_add_epi32(acc1, _mm256_madd_epi16(_mm256_unpackhi_epi8(LO, ZERO), W));
+            acc2 = _mm256_add_epi32(acc2, _mm256_madd_epi16(_mm256_unpacklo_epi8(HI, ZERO), W));
+            acc3 = _mm256_add_epi32(acc3, _mm256_madd_epi16(_mm256_unpackhi_epi8(HI, ZERO), W));
+        }
+
+        const __m256i P01 = _mm256_packs_epi32(_mm256_srai_epi32(acc0, PRECISION), _mm256_srai_epi32(acc1, PRECISION));
+        const __m256i P23 = _mm256_packs_epi32(_mm256_srai_epi32(acc2, PRECISION), _mm256_srai_epi32(acc3, PRECISION));
+        __m256i       px  = _mm256_packus_epi16(P01, P23);
+
+        const __m256i A = _mm256_srli_epi32(px, 24);
+        __m256i       t = _mm256_or_si256(A, _mm256_slli_epi32(A, 8));
+        t               = _mm256_or_si256(t, _mm256_slli_epi32(t, 16));
+        px              = _mm256_min_epu8(px, t);
+
+        _mm256_storeu_si256((__m256i*)(dst + x), px);
+    }
+
+    _mm256_zeroupper();
+
+    verticalTail(src, stride, dst, x, width, start, taps, weights);
+}
+
+#endif
+
+#ifdef RESAMPLE_NEON
+
+static uint8x16_t clampToAlphaNEON(uint8x16_t px) {
+    const uint32x4_t A = vshrq_n_u32(vreinterpretq_u32_u8(px), 24);
+    return vminq_u8(px, vreinterpretq_u8_u32(vmulq_n_u32(A, 0x01010101)));
+}
+
+static void horizontalNEON(const uint32_t* src, uint32_t* dst, int width, const SKernel& kernel) {
+    for (int x = 0; x < width; ++x) {
+        const auto ROW = src + kernel.start[x];
+        const auto W   = kernel.weightsFor(x);
+
+        int32x4_t  acc = vdupq_n_s32(ROUND);
+
+        for (int k = 0; k < kernel.taps[x]; ++k) {
+            const int16x4_t PX = vreinterpret_s16_u16(vget_low_u16(vmovl_u8(vcreate_u8(ROW[k]))));
+            acc                = vmlal_n_s16(acc, PX, W[k]);
+        }
+
+        const uint16x4_t  C  = vqmovun_s32(vshrq_n_s32(acc, PRECISION));
+        const uint8x8_t   PX = vqmovn_u16(vcombine_u16(C, C));
+        const uint8x16_t  CL = clampToAlphaNEON(vcombine_u8(PX, PX));
+
+        dst[x] = vgetq_lane_u32(vreinterpretq_u32_u8(CL), 0);
+    }
+}
+
+static void verticalNEON(const uint8_t* src, size_t stride, uint32_t* dst, int width, int start, int taps, const int16_t* weights) {
+    int x = 0;
+    for (; x + 4 <= width; x += 4) {
+        int32x4_t acc0 = vdupq_n_s32(ROUND), acc1 = acc0, acc2 = acc0, acc3 = acc0;
+
+        for (int k = 0; k < taps; ++k) {
+            const uint8x16_t A  = vld1q_u8(src + (start + k) * stride + x * 4);
+            const int16x8_t  LO = vreinterpretq_s16_u16(vmovl_u8(vget_low_u8(A)));
+            const int16x8_t  HI = vreinterpretq_s16_u16(vmovl_u8(vget_high_u8(A)));
+
+            acc0 = vmlal_n_s16(acc0, vget_low_s16(LO), weights[k]);
+            acc1 = vmlal_n_s16(acc1, vget_high_s16(LO), weights[k]);
+            acc2 = vmlal_n_s16(acc2, vget_low_s16(HI), weights[k]);
+            acc3 = vmlal_n_s16(acc3, vget_high_s16(HI), weights[k]);
+        }
+
+        const uint16x8_t P01 = vcombine_u16(vqmovun_s32(vshrq_n_s32(acc0, PRECISION)), vqmovun_s32(vshrq_n_s32(acc1, PRECISION)));
+        const uint16x8_t P23 = vcombine_u16(vqmovun_s32(vshrq_n_s32(acc2, PRECISION)), vqmovun_s32(vshrq_n_s32(acc3, PRECISION)));
+
+        vst1q_u8((uint8_t*)(dst + x), clampToAlphaNEON(vcombine_u8(vqmovn_u16(P01), vqmovn_u16(P23))));
+    }
+
+    verticalTail(src, stride, dst, x, width, start, taps, weights);
+}
+
+#endif
+
+struct SKernels {
+    void (*horizontal)(const uint32_t* src, uint32_t* dst, int width, const SKernel& kernel);
+    void (*vertical)(const uint8_t* src, size_t stride, uint32_t* dst, int width, int start, int taps, const int16_t* weights);
+    const char* name;
+};
+
+// every set this machine can run, best last
+static const std::vector<SKernels>& availableKernels() {
+    static const std::vector<SKernels> AVAILABLE = []() {
+        std::vector<SKernels> available = {{horizontalScalar, verticalScalar, "scalar"}};
+#if defined(RESAMPLE_X86)
+        available.push_back({horizontalSSE2, verticalSSE2, "sse2"});
+
+        if (__builtin_cpu_supports("avx2"))
+            available.push_back({horizontalAVX2, verticalAVX2, "avx2"});
+#elif defined(RESAMPLE_NEON)
+        available.push_back({horizontalNEON, verticalNEON, "neon"});
+#endif
+        return available;
+    }();
+
+    return AVAILABLE;
+}
+
+static const SKernels* findKernels(std::string_view name) {
+    const auto& AVAILABLE = availableKernels();
+    const auto  IT        = std::ranges::find_if(AVAILABLE, [name](const SKernels& k) { return k.name == name; });
+
+    return IT == AVAILABLE.end() ? nullptr : &*IT;
+}
+
+static std::atomic<const SKernels*>& currentKernels() {
+    static std::atomic<const SKernels*> current = []() {
+        const auto ENV = getenv("HYPRCURSOR_RESAMPLE_KERNELS");
+
+        if (const auto KERNELS = ENV ? findKernels(ENV) : nullptr; KERNELS)
+            return KERNELS;
+
+        return &availableKernels().back();
+    }();
+
+    return current;
+}
+
+static const SKernels& kernels() {
+    return *currentKernels().load(std::memory_order_relaxed);
+}
+
+static void resampleNearest(const uint8_t* src, int srcW, int srcH, int srcStride, uint8_t* dst, int dstW, int dstH, int dstStride) {
+    // a gather, nothing for simd to speed up
+    std::vector<int> columns(dstW);
+    for (int x = 0; x < dstW; ++x) {
+        columns[x] = std::min(srcW - 1, (int)((x + 0.5) * srcW / dstW));
+    }
+
+    for (int y = 0; y < dstH; ++y) {
+        const auto SRCROW = (const uint32_t*)(src + (size_t)std::min(srcH - 1, (int)((y + 0.5) * srcH / dstH)) * srcStride);
+        const auto DSTROW = (uint32_t*)(dst + (size_t)y * dstStride);
+
+        for (int x = 0; x < dstW; ++x) {
+            DSTROW[x] = SRCROW[columns[x]];
+        }
+    }
+}
+
+bool Resample::resample(const uint8_t* src, int srcW, int srcH, int srcStride, uint8_t* dst, int dstW, int dstH, int dstStride, eHyprcursorResizeAlgo algo) {
+    if (!src || !dst || srcW <= 0 || srcH <= 0 || dstW <= 0 || dstH <= 0 || srcStride < srcW * 4 || dstStride < dstW * 4)
+        return false;
+
+    double (*filter)(double) = nullptr;
+    double support           = 0;
+
+    switch (algo) {
+        case HC_RESIZE_BILINEAR:
+            filter  = filterTriangle;
+            support = 1.0;
+            break;
+        case HC_RESIZE_BOX:
+            filter  = filterBox;
+            support = 0.5;
+            break;
+        case HC_RESIZE_LANCZOS:
+            filter  = filterLanczos;
+            support = 3.0;
+            break;
+        default: resampleNearest(src, srcW, srcH, srcStride, dst, dstW, dstH, dstStride); return true;
+    }
+
+    const auto&           K          = kernels();
+    const SKernel         HORIZONTAL = makeKernel(srcW, dstW, filter, support);
+    const SKernel         VERTICAL   = makeKernel(srcH, dstH, filter, support);
+
+    // horizontal pass first, into a dstW x srcH buffer. Only rows the vertical pass reads are done.
+    std::vector<uint32_t> scratch((size_t)dstW * srcH);
+    const int             FIRSTROW = VERTICAL.start.front();
+    const int             LASTROW  = VERTICAL.start.back() + VERTICAL.taps.back();
+
+    for (int y = FIRSTROW; y < LASTROW; ++y) {
+        K.horizontal((const uint32_t*)(src + (size_t)y * srcStride), scratch.data() + (size_t)y * dstW, dstW, HORIZONTAL);
+    }
+
+    for (int y = 0; y < dstH; ++y) {
+        K.vertical((const uint8_t*)scratch.data(), (size_t)dstW * 4, (uint32_t*)(dst + (size_t)y * dstStride), dstW, VERTICAL.start[y], VERTICAL.taps[y],
+                   VERTICAL.weightsFor(y));
+    }
+
+    return true;
+}
+
+const char* Resample::kernelName() {
+    return kernels().name;
+}
+
+std::vector<const char*> Resample::availableKernels() {
+    std::vector<const char*> names;
+
+    for (auto& k : ::availableKernels()) {
+        names.push_back(k.name);
+    }
+
+    return names;
+}
+
+bool Resample::useKernels(const char* name) {
+    const auto KERNELS = name ? findKernels(name) : nullptr;
+
+    if (!KERNELS)
+        return false;
+
+    currentKernels().store(KERNELS, std::memory_order_relaxed);
+
+    return true;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <hyprcursor/shared.h>
+
+/*
+    Image resampling for resized png shapes.
+
+    Works on premultiplied ARGB32, stored like cairo stores it: one native-endian
+    uint32 per pixel, alpha in the top byte. Strides are in bytes.
+
+    Filtered algorithms are separable and account for the scale, so large reductions
+    average every source pixel instead of skipping most of them like a bilinear
+    pattern would. Kernels use AVX2, SSE2 or NEON when available, with a scalar fallback.
+    All of them give the same output. HYPRCURSOR_RESAMPLE_KERNELS=scalar (or sse2, avx2, neon)
+    picks other kernels than the best ones available.
+*/
+namespace Resample {
+
+    /*
+        Resamples src into dst with algo. HC_RESIZE_NONE and HC_RESIZE_INVALID resample like
+        HC_RESIZE_NEAREST. Returns false if the sizes are invalid.
+    */
+    bool resample(const uint8_t* src, int srcW, int srcH, int srcStride, uint8_t* dst, int dstW, int dstH, int dstStride, eHyprcursorResizeAlgo algo);
+
+    /*
+        Which kernels resample() uses on this machine, for logs and benchmarks.
+    */
+    const char* kernelName();
+
+    /*
+        Names of the kernels this machine can run, scalar first and the best last.
+    */
+    std::vector<const char*> availableKernels();
+
+    /*
+        Makes resample() use the named kernels, for tests and benchmarks. Returns false,
+        and changes nothing, if this machine can't run them.
+    */
+    bool useKernels(const char* name);
+};
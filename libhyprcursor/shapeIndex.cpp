@@ -0,0 +1,127 @@
+#include "shapeIndex.hpp"
+#include "themePack.hpp"
+
+#include <functional>
+#include <bit>
+#include <algorithm>
+
+void CShapeIndex::build(const SCursorTheme& theme) {
+    size_t names = 0;
+    for (auto& shape : theme.shapes) {
+        names += 1 + shape->overrides.size();
+    }
+
+    pack      = nullptr;
+    packTheme = nullptr;
+
+    // keep the load factor at or below 1/2, so probe runs stay short
+    entries.clear();
+    entries.resize(std::bit_ceil(std::max(names * 2, (size_t)8)));
+    used = 0;
+
+    for (size_t i = 0; i < theme.shapes.size(); ++i) {
+        const auto& shape = theme.shapes[i];
+        const auto  OWNED = insert(shape->directory);
+
+        if (!OWNED->shape) {
+            OWNED->shape  = shape.get();
+            OWNED->handle = i + 1;
+        }
+        if (!OWNED->owner)
+            OWNED->owner = shape.get();
+
+        for (auto& o : shape->overrides) {
+            const auto OVERRIDDEN = insert(o);
+
+            if (!OVERRIDDEN->shape) {
+                OVERRIDDEN->shape  = shape.get();
+                OVERRIDDEN->handle = i + 1;
+            }
+            if (!OVERRIDDEN->overriddenBy && o != shape->directory)
+                OVERRIDDEN->overriddenBy = shape.get();
+        }
+    }
+}
+
+void CShapeIndex::build(const SCursorTheme& theme, std::shared_ptr<CThemePack> pack_) {
+    entries.clear();
+    used      = 0;
+    pack      = pack_;
+    packTheme = &theme;
+}
+
+CShapeIndex::SEntry* CShapeIndex::insert(std::string_view name) {
+    const uint64_t HASH = std::hash<std::string_view>{}(name);
+    const size_t   MASK = entries.size() - 1;
+
+    for (size_t i = HASH & MASK;; i = (i + 1) & MASK) {
+        auto& e = entries[i];
+
+        if (e.name.data() && (e.hash != HASH || e.name != name))
+            continue;
+
+        if (!e.name.data()) {
+            e.name = name;
+            e.hash = HASH;
+            used++;
+        }
+
+        return &e;
+    }
+}
+
+std::optional<CShapeIndex::SEntry> CShapeIndex::findInPack(std::string_view name) const {
+    const auto PACKNAME = pack->findName(name);
+    if (!PACKNAME)
+        return std::nullopt;
+
+    SEntry entry{.name = pack->string(PACKNAME->name, PACKNAME->nameLen)};
+
+    // refs are in priority order, same as build() walks the theme
+    for (uint32_t i = 0; i < PACKNAME->refCount; ++i) {
+        const auto REF = pack->ref(PACKNAME->firstRef + i);
+        if (!REF || REF->shape >= packTheme->shapes.size())
+            continue;
+
+        const auto SHAPE = packTheme->shapes[REF->shape].get();
+
+        if (!entry.shape) {
+            entry.shape  = SHAPE;
+            entry.handle = REF->shape + 1;
+        }
+        if (!entry.owner && REF->named)
+            entry.owner = SHAPE;
+        if (!entry.overriddenBy && !REF->named)
+            entry.overriddenBy = SHAPE;
+    }
+
+    if (!entry.shape)
+        return std::nullopt;
+
+    return entry;
+}
+
+std::optional<CShapeIndex::SEntry> CShapeIndex::find(std::string_view name) const {
+    if (pack)
+        return findInPack(name);
+
+    if (entries.empty())
+        return std::nullopt;
+
+    const uint64_t HASH = std::hash<std::string_view>{}(name);
+    const size_t   MASK = entries.size() - 1;
+
+    for (size_t i = HASH & MASK;; i = (i + 1) & MASK) {
+        const auto& e = entries[i];
+
+        if (!e.name.data())
+            return std::nullopt;
+
+        if (e.hash == HASH && e.name == name)
+            return e;
+    }
+}
+
+size_t CShapeIndex::size() const {
+    return pack ? pack->nameCount() : used;
+}
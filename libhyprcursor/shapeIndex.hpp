@@ -0,0 +1,55 @@
+#pragma once
+
+#include <string_view>
+#include <vector>
+#include <optional>
+#include <memory>
+#include <cstdint>
+
+#include "internalSharedTypes.hpp"
+
+class CThemePack;
+
+/*
+    Flat open-addressing hash table from shape names and overrides to shapes.
+    Keys point into the theme's strings, so the theme must outlive the index
+    and not change after build().
+
+    For a theme loaded from a pack, nothing is built, names are looked up
+    in the pack's sorted table instead.
+*/
+class CShapeIndex {
+  public:
+    struct SEntry {
+        std::string_view name;
+        uint64_t         hash = 0;
+
+        // first shape, in theme order, named or overridden by name
+        SCursorShape*    shape = nullptr;
+        // handle of shape, its index in the theme + 1
+        uint32_t         handle = 0;
+        // shape whose directory is name, if any
+        SCursorShape*    owner = nullptr;
+        // first shape, in theme order, that overrides name and isn't named name
+        SCursorShape*    overriddenBy = nullptr;
+    };
+
+    void                  build(const SCursorTheme& theme);
+    // theme's shapes have to be the pack's, in order
+    void                  build(const SCursorTheme& theme, std::shared_ptr<CThemePack> pack);
+
+    // returns nothing if nothing is called name
+    std::optional<SEntry> find(std::string_view name) const;
+
+    size_t                size() const;
+
+  private:
+    SEntry*                     insert(std::string_view name);
+    std::optional<SEntry>       findInPack(std::string_view name) const;
+
+    std::vector<SEntry>         entries;
+    size_t                      used = 0;
+
+    const SCursorTheme*         packTheme = nullptr;
+    std::shared_ptr<CThemePack> pack;
+};
@@ -0,0 +1,521 @@
+#include "themeIndex.hpp"
+#include "manifest.hpp"
+#include "Parallel.hpp"
+#include "Log.hpp"
+
+#include <array>
+#include <mutex>
+#include <memory>
+#include <sstream>
+#include <fstream>
+#include <filesystem>
+#include <algorithm>
+#include <sys/stat.h>
+#include <unistd.h>
+
+constexpr const char*                      INDEX_HEADER  = "hyprcursor-theme-index 2";
+constexpr const std::array<const char*, 2> userThemeDirs = {"/.local/share/icons", "/.icons"};
+
+// a "T" record: the tag, then the STheme fields, see themeRecord
+constexpr size_t THEME_RECORD_FIELDS = 14;
+
+static std::vector<std::string> getSystemThemeDirs() {
+    const auto               envXdgData = std::getenv("XDG_DATA_DIRS");
+    std::vector<std::string> result;
+    if (envXdgData) {
+        std::stringstream envXdgStream(envXdgData);
+        std::string       tmpStr;
+        while (getline(envXdgStream, tmpStr, ':'))
+            result.push_back((tmpStr + "/icons"));
+    } else
+        result = {"/usr/share/icons"};
+
+    return result;
+}
+
+std::vector<std::string> getThemeSearchRoots() {
+    std::vector<std::string> result;
+
+    if (const auto HOMEENV = getenv("HOME"); HOMEENV) {
+        for (auto& dir : userThemeDirs) {
+            result.push_back(std::string{HOMEENV} + dir);
+        }
+    }
+
+    for (auto& dir : getSystemThemeDirs()) {
+        result.push_back(dir);
+    }
+
+    return result;
+}
+
+bool pathAccessible(const std::string& path) {
+    try {
+        if (!std::filesystem::exists(path))
+            return false;
+
+    } catch (std::exception& e) { return false; }
+
+    return true;
+}
+
+bool themeAccessible(const std::string& path) {
+    return pathAccessible(path + "/manifest.hl") || pathAccessible(path + "/manifest.toml");
+}
+
+static size_t discoveryThreads() {
+    // discovery is mostly waiting on the filesystem, so this doesn't need to track the core count closely
+    return std::clamp<size_t>(std::thread::hardware_concurrency(), 2, 8);
+}
+
+static int64_t mtimeOf(const std::string& path) {
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0)
+        return -1;
+
+    return (int64_t)st.st_mtim.tv_sec * 1000000000LL + st.st_mtim.tv_nsec;
+}
+
+static std::string indexPath() {
+    if (const auto XDGCACHE = getenv("XDG_CACHE_HOME"); XDGCACHE && *XDGCACHE)
+        return std::string{XDGCACHE} + "/hyprcursor/themes.idx";
+
+    if (const auto HOMEENV = getenv("HOME"); HOMEENV)
+        return std::string{HOMEENV} + "/.cache/hyprcursor/themes.idx";
+
+    return "";
+}
+
+static std::string escapeField(const std::string& in) {
+    std::string out;
+    out.reserve(in.size());
+    for (const char c : in) {
+        switch (c) {
+            case '\\': out += "\\\\"; break;
+            case '\t': out += "\\t"; break;
+            case '\n': out += "\\n"; break;
+            default: out += c; break;
+        }
+    }
+    return out;
+}
+
+static std::vector<std::string> splitFields(const std::string& line) {
+    std::vector<std::string> fields{""};
+    for (size_t i = 0; i < line.size(); ++i) {
+        const char c = line[i];
+        if (c == '\t') {
+            fields.emplace_back();
+            continue;
+        }
+
+        if (c == '\\' && i + 1 < line.size()) {
+            const char NEXT = line[++i];
+            fields.back() += NEXT == 't' ? '\t' : (NEXT == 'n' ? '\n' : NEXT);
+            continue;
+        }
+
+        fields.back() += c;
+    }
+    return fields;
+}
+
+// the writer goes through this, so it can't disagree with the reader about the field count
+static std::array<std::string, THEME_RECORD_FIELDS> themeRecord(const CThemeIndex::STheme& t) {
+    return {"T",
+            t.stem,
+            t.path,
+            std::to_string((int)t.state),
+            t.fullPath,
+            t.manifestPath,
+            std::to_string(t.dirMtime),
+            std::to_string(t.manifestMtime),
+            t.manifestParsed ? (t.manifestValid ? "2" : "1") : "0",
+            t.manifest.name,
+            t.manifest.description,
+            t.manifest.version,
+            t.manifest.author,
+            t.manifest.cursorsDirectory};
+}
+
+CThemeIndex::CThemeIndex(PHYPRCURSORLOGFUNC logFn_) : logFn(logFn_) {
+    ;
+}
+
+void CThemeIndex::ensureLoaded() {
+    rebuilt = false;
+
+    if (loaded) {
+        if (invalid || !cacheValid()) {
+            Debug::log(HC_LOG_TRACE, logFn, "CThemeIndex: index stale, rescanning");
+            rebuild();
+        }
+        return;
+    }
+
+    loaded = true;
+
+    if (loadCache() && cacheValid()) {
+        Debug::log(HC_LOG_TRACE, logFn, "CThemeIndex: using cached index from {}", indexPath());
+        return;
+    }
+
+    Debug::log(HC_LOG_TRACE, logFn, "CThemeIndex: index missing or stale, rescanning");
+
+    rebuild();
+}
+
+bool CThemeIndex::loadCache() {
+    const auto PATH = indexPath();
+    if (PATH.empty())
+        return false;
+
+    std::ifstream file(PATH);
+    if (!file.good())
+        return false;
+
+    std::string line;
+    if (!std::getline(file, line) || line != INDEX_HEADER)
+        return false;
+
+    roots.clear();
+
+    try {
+        while (std::getline(file, line)) {
+            const auto FIELDS = splitFields(line);
+
+            if (FIELDS[0] == "R" && FIELDS.size() == 3) {
+                roots.emplace_back(SRoot{.path = FIELDS[1], .mtime = std::stoll(FIELDS[2])});
+                continue;
+            }
+
+            if (FIELDS[0] == "T" && FIELDS.size() == THEME_RECORD_FIELDS && !roots.empty()) {
+                auto& theme                     = roots.back().themes.emplace_back();
+                theme.stem                      = FIELDS[1];
+                theme.path                      = FIELDS[2];
+                theme.state                     = (eThemeState)std::clamp(std::stoi(FIELDS[3]), (int)THEME_UNRESOLVED, (int)THEME_VALID);
+                theme.fullPath                  = FIELDS[4];
+                theme.manifestPath              = FIELDS[5];
+                theme.dirMtime                  = std::stoll(FIELDS[6]);
+                theme.manifestMtime             = std::stoll(FIELDS[7]);
+                theme.manifestParsed            = FIELDS[8] != "0";
+                theme.manifestValid             = FIELDS[8] == "2";
+                theme.manifest.name             = FIELDS[9];
+                theme.manifest.description      = FIELDS[10];
+                theme.manifest.version          = FIELDS[11];
+                theme.manifest.author           = FIELDS[12];
+                theme.manifest.cursorsDirectory = FIELDS[13];
+                continue;
+            }
+
+            roots.clear();
+            return false;
+        }
+    } catch (std::exception& e) {
+        roots.clear();
+        return false;
+    }
+
+    return true;
+}
+
+bool CThemeIndex::entryValid(const STheme& theme) {
+    if (theme.state == THEME_UNRESOLVED)
+        return true;
+
+    if (theme.dirMtime != mtimeOf(theme.path))
+        return false;
+
+    return theme.state != THEME_VALID || theme.manifestMtime == mtimeOf(theme.manifestPath);
+}
+
+bool CThemeIndex::cacheValid() {
+    const auto SEARCHROOTS = getThemeSearchRoots();
+
+    if (SEARCHROOTS.size() != roots.size())
+        return false;
+
+    for (size_t i = 0; i < roots.size(); ++i) {
+        if (roots[i].path != SEARCHROOTS[i] || roots[i].mtime != mtimeOf(roots[i].path))
+            return false;
+
+        for (auto& theme : roots[i].themes) {
+            if (!entryValid(theme))
+                return false;
+        }
+    }
+
+    return true;
+}
+
+CThemeIndex::SRoot CThemeIndex::scanRoot(const std::string& path, std::unordered_map<std::string, STheme>& previous) {
+    SRoot root{.path = path, .mtime = mtimeOf(path)};
+
+    if (root.mtime < 0 || !pathAccessible(path)) {
+        Debug::log(HC_LOG_TRACE, logFn, "Skipping path {} because it's inaccessible.", path);
+        root.mtime = -1;
+        return root;
+    }
+
+    try {
+        for (auto& themeDir : std::filesystem::directory_iterator(path)) {
+            if (!themeDir.is_directory())
+                continue;
+
+            const auto THEMEPATH = themeDir.path().string();
+
+            if (const auto IT = previous.find(THEMEPATH); IT != previous.end()) {
+                root.themes.emplace_back(std::move(IT->second));
+                continue;
+            }
+
+            root.themes.emplace_back(STheme{.stem = themeDir.path().stem().string(), .path = THEMEPATH});
+        }
+    } catch (std::exception& e) { Debug::log(HC_LOG_WARN, logFn, "CThemeIndex: failed scanning {}: {}", path, e.what()); }
+
+    return root;
+}
+
+void CThemeIndex::rebuild() {
+    // keep whatever we resolved before, as long as it's still up to date
+    std::unordered_map<std::string, STheme> previous;
+    for (auto& root : roots) {
+        for (auto& theme : root.themes) {
+            if (theme.state != THEME_UNRESOLVED && entryValid(theme))
+                previous.emplace(theme.path, std::move(theme));
+        }
+    }
+
+    const auto SEARCHROOTS = getThemeSearchRoots();
+
+    roots.clear();
+    roots.resize(SEARCHROOTS.size());
+    rebuilt = true;
+    invalid = false;
+    dirty   = true;
+
+    // a path can only live in one root, so workers never touch the same previous entry
+    Parallel::forEach(SEARCHROOTS.size(), discoveryThreads(), [&](size_t i) { roots[i] = scanRoot(SEARCHROOTS[i], previous); });
+}
+
+void CThemeIndex::saveCache() {
+    if (!dirty)
+        return;
+
+    dirty = false;
+
+    const auto PATH = indexPath();
+    if (PATH.empty())
+        return;
+
+    const auto TMPPATH = PATH + ".tmp" + std::to_string(getpid());
+
+    try {
+        std::filesystem::create_directories(std::filesystem::path(PATH).parent_path());
+
+        std::ofstream file(TMPPATH, std::ios::trunc);
+        if (!file.good())
+            return;
+
+        file << INDEX_HEADER << "\n";
+
+        for (auto& root : roots) {
+            file << "R\t" << escapeField(root.path) << "\t" << root.mtime << "\n";
+
+            for (auto& t : root.themes) {
+                const auto RECORD = themeRecord(t);
+                for (size_t i = 0; i < RECORD.size(); ++i) {
+                    file << (i == 0 ? "" : "\t") << escapeField(RECORD[i]);
+                }
+                file << "\n";
+            }
+        }
+
+        file.close();
+
+        if (!file.good()) {
+            std::filesystem::remove(TMPPATH);
+            return;
+        }
+
+        std::filesystem::rename(TMPPATH, PATH);
+    } catch (std::exception& e) {
+        Debug::log(HC_LOG_TRACE, logFn, "CThemeIndex: failed writing {}: {}", PATH, e.what());
+        std::error_code ec;
+        std::filesystem::remove(TMPPATH, ec);
+    }
+}
+
+void CThemeIndex::resolve(STheme& theme) {
+    if (theme.state != THEME_UNRESOLVED)
+        return;
+
+    dirty          = true;
+    theme.dirMtime = mtimeOf(theme.path);
+
+    if (pathAccessible(theme.path + "/manifest.hl"))
+        theme.manifestPath = theme.path + "/manifest.hl";
+    else if (pathAccessible(theme.path + "/manifest.toml"))
+        theme.manifestPath = theme.path + "/manifest.toml";
+    else {
+        Debug::log(HC_LOG_TRACE, logFn, "Skipping theme {} because it's inaccessible.", theme.path);
+        theme.state = THEME_INVALID;
+        return;
+    }
+
+    std::error_code ec;
+    theme.fullPath      = std::filesystem::canonical(theme.path, ec).string();
+    theme.manifestMtime = mtimeOf(theme.manifestPath);
+    theme.state         = ec ? THEME_INVALID : THEME_VALID;
+}
+
+void CThemeIndex::parseManifest(STheme& theme) {
+    resolve(theme);
+
+    if (theme.state != THEME_VALID || theme.manifestParsed)
+        return;
+
+    dirty                = true;
+    theme.manifestParsed = true;
+
+    CManifest manifest{theme.path + "/manifest"};
+    if (const auto R = manifest.parse(); R.has_value()) {
+        Debug::log(HC_LOG_ERR, logFn, "failed parsing Manifest of {}: {}", theme.path, *R);
+        return;
+    }
+
+    theme.manifestValid             = true;
+    theme.manifest.name             = manifest.parsedData.name;
+    theme.manifest.description      = manifest.parsedData.description;
+    theme.manifest.version          = manifest.parsedData.version;
+    theme.manifest.author           = manifest.parsedData.author;
+    theme.manifest.cursorsDirectory = manifest.parsedData.cursorsDirectory;
+}
+
+CThemeIndex::STheme* CThemeIndex::firstMatching(const std::function<bool(STheme&)>& pred) {
+    std::vector<STheme*> candidates;
+    for (auto& root : roots) {
+        for (auto& theme : root.themes) {
+            candidates.push_back(&theme);
+        }
+    }
+
+    // workers take candidates in priority order, so anything past the best match so far can be skipped
+    std::atomic<size_t> best = candidates.size();
+
+    Parallel::forEach(candidates.size(), discoveryThreads(), [&](size_t i) {
+        if (i > best.load() || !pred(*candidates[i]))
+            return;
+
+        size_t current = best.load();
+        while (i < current && !best.compare_exchange_weak(current, i)) {
+            ;
+        }
+    });
+
+    return best == candidates.size() ? nullptr : candidates[best];
+}
+
+const CThemeIndex::STheme* CThemeIndex::lookup(const std::string& name) {
+    // first pass: directory stems, only the matching directories are parsed
+    for (auto& root : roots) {
+        for (auto& theme : root.themes) {
+            if (theme.stem != name)
+                continue;
+
+            // a broken theme doesn't win just for its directory name. The parse result is kept in the index.
+            parseManifest(theme);
+
+            if (theme.manifestValid)
+                return &theme;
+        }
+    }
+
+    // second pass: manifest names
+    return firstMatching([this, &name](STheme& theme) {
+        parseManifest(theme);
+        return theme.manifestValid && theme.manifest.name == name;
+    });
+}
+
+const CThemeIndex::STheme* CThemeIndex::findTheme(const std::string& name) {
+    ensureLoaded();
+
+    auto THEME = lookup(name);
+
+    if (!THEME && !rebuilt) {
+        // the index is validated by mtimes, which can miss in-place changes. Rescan before giving up.
+        Debug::log(HC_LOG_TRACE, logFn, "CThemeIndex: {} not in index, rescanning", name);
+
+        rebuild();
+        THEME = lookup(name);
+    }
+
+    saveCache();
+
+    return THEME;
+}
+
+const CThemeIndex::STheme* CThemeIndex::firstTheme() {
+    ensureLoaded();
+
+    const auto THEME = firstMatching([this](STheme& theme) {
+        resolve(theme);
+        return theme.state == THEME_VALID;
+    });
+
+    saveCache();
+
+    return THEME;
+}
+
+std::vector<const CThemeIndex::STheme*> CThemeIndex::allThemes() {
+    ensureLoaded();
+
+    std::vector<STheme*> candidates;
+    for (auto& root : roots) {
+        for (auto& theme : root.themes) {
+            candidates.push_back(&theme);
+        }
+    }
+
+    Parallel::forEach(candidates.size(), discoveryThreads(), [&](size_t i) { parseManifest(*candidates[i]); });
+
+    saveCache();
+
+    // a theme shadows any theme with the same stem in a later root
+    std::vector<const STheme*> result;
+    for (const auto& theme : candidates) {
+        if (!theme->manifestValid)
+            continue;
+
+        if (std::find_if(result.begin(), result.end(), [theme](const auto& other) { return other->stem == theme->stem; }) != result.end())
+            continue;
+
+        result.push_back(theme);
+    }
+
+    return result;
+}
+
+void CThemeIndex::setLogFunction(PHYPRCURSORLOGFUNC fn) {
+    logFn = fn;
+}
+
+void CThemeIndex::invalidate() {
+    invalid = true;
+}
+
+static std::mutex                   sharedIndexMutex;
+static std::unique_ptr<CThemeIndex> sharedIndex;
+
+SLockedThemeIndex lockThemeIndex(PHYPRCURSORLOGFUNC logFn) {
+    std::unique_lock<std::mutex> lock(sharedIndexMutex);
+
+    if (!sharedIndex)
+        sharedIndex = std::make_unique<CThemeIndex>(logFn);
+
+    sharedIndex->setLogFunction(logFn);
+
+    return SLockedThemeIndex{.lock = std::move(lock), .index = sharedIndex.get()};
+}
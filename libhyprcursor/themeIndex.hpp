@@ -0,0 +1,121 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <atomic>
+#include <functional>
+#include <unordered_map>
+#include <mutex>
+#include <hyprcursor/shared.h>
+
+/*
+    Returns the theme search roots, in priority order:
+    user directories first, then XDG_DATA_DIRS.
+*/
+std::vector<std::string> getThemeSearchRoots();
+
+bool                     pathAccessible(const std::string& path);
+bool                     themeAccessible(const std::string& path);
+
+/*
+    Index of installed hyprcursor themes.
+
+    The index is persisted in $XDG_CACHE_HOME/hyprcursor/ and validated
+    against the mtimes of the search roots, theme directories and manifests.
+    If it's missing or stale, the roots are listed again.
+
+    Listing a root only records directory names. Whether a directory is a theme,
+    and what its manifest says, is resolved on demand and remembered.
+
+    Roots are listed, and themes resolved, on a small worker pool,
+    but results always follow the search root priority.
+*/
+class CThemeIndex {
+  public:
+    CThemeIndex(PHYPRCURSORLOGFUNC logFn_);
+
+    enum eThemeState : uint8_t {
+        THEME_UNRESOLVED = 0,
+        THEME_INVALID,
+        THEME_VALID,
+    };
+
+    struct STheme {
+        std::string stem, path, fullPath, manifestPath;
+        int64_t     dirMtime = -1, manifestMtime = -1;
+        eThemeState state          = THEME_UNRESOLVED;
+        bool        manifestParsed = false, manifestValid = false;
+
+        struct {
+            std::string name, description, version, author, cursorsDirectory;
+        } manifest;
+    };
+
+    struct SRoot {
+        std::string         path;
+        int64_t             mtime = -1; // -1 means inaccessible
+        std::vector<STheme> themes;
+    };
+
+    /*
+        Returns a theme matching name, or nullptr.
+
+        Directory stems are matched first, across all roots. Only matching directories have
+        their manifest parsed, and it has to parse. If none match, all manifests are parsed to match their name.
+    */
+    const STheme* findTheme(const std::string& name);
+
+    /*
+        Returns the first theme found in the hierarchy, or nullptr.
+    */
+    const STheme* firstTheme();
+
+    /*
+        Returns every theme with a valid manifest, in priority order.
+        Themes shadowed by one with the same stem in an earlier root are left out.
+    */
+    std::vector<const STheme*> allThemes();
+
+    void                       setLogFunction(PHYPRCURSORLOGFUNC fn);
+
+    /*
+        Forces the roots to be listed again on next use, e.g. after the watcher saw a change.
+    */
+    void invalidate();
+
+  private:
+    void               ensureLoaded();
+    bool               loadCache();
+    bool               cacheValid();
+    bool               entryValid(const STheme& theme);
+    SRoot              scanRoot(const std::string& path, std::unordered_map<std::string, STheme>& previous);
+    void               rebuild();
+    void               saveCache();
+    void               resolve(STheme& theme);
+    void               parseManifest(STheme& theme);
+    STheme*            firstMatching(const std::function<bool(STheme&)>& pred);
+    const STheme*      lookup(const std::string& name);
+
+    std::vector<SRoot> roots;
+    bool               loaded  = false;
+    bool               rebuilt = false;
+    bool               invalid = false;
+    std::atomic<bool>  dirty   = false;
+    PHYPRCURSORLOGFUNC logFn   = nullptr;
+};
+
+struct SLockedThemeIndex {
+    std::unique_lock<std::mutex> lock;
+    CThemeIndex*                 index = nullptr;
+
+    CThemeIndex*                 operator->() {
+        return index;
+    }
+};
+
+/*
+    Returns the process-wide index, shared by all managers and theme enumeration.
+    It stays locked until the returned object is destroyed.
+*/
+SLockedThemeIndex lockThemeIndex(PHYPRCURSORLOGFUNC logFn);
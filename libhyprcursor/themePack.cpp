@@ -0,0 +1,289 @@
+#include "themePack.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <cstring>
+#include <vector>
+#include <map>
+#include <algorithm>
+
+template <typename T>
+static bool recordsFit(uint64_t offset, uint64_t count, size_t fileSize) {
+    return offset % alignof(T) == 0 && offset <= fileSize && count <= (fileSize - offset) / sizeof(T);
+}
+
+CThemePack::CThemePack(const std::string& path) : file(path) {
+    if (!file.good() || file.size() < sizeof(SPackHeader))
+        return;
+
+    const auto HEADER = (const SPackHeader*)file.data();
+
+    if (std::memcmp(HEADER->magic, PACK_MAGIC, sizeof(PACK_MAGIC)) != 0 || HEADER->version != PACK_VERSION || HEADER->byteOrder != PACK_BYTE_ORDER ||
+        HEADER->fileSize != file.size())
+        return;
+
+    if (!recordsFit<SPackShape>(HEADER->shapesOffset, HEADER->shapeCount, file.size()) || !recordsFit<SPackName>(HEADER->namesOffset, HEADER->nameCount, file.size()) ||
+        !recordsFit<SPackRef>(HEADER->refsOffset, HEADER->refCount, file.size()) || !recordsFit<SPackFrame>(HEADER->framesOffset, HEADER->frameCount, file.size()) || !recordsFit<char>(HEADER->stringsOffset, HEADER->stringsSize, file.size()))
+        return;
+
+    header = HEADER;
+}
+
+bool CThemePack::good() {
+    return header;
+}
+
+uint32_t CThemePack::shapeCount() {
+    return header ? header->shapeCount : 0;
+}
+
+uint32_t CThemePack::nameCount() {
+    return header ? header->nameCount : 0;
+}
+
+uint64_t CThemePack::sourceStamp() {
+    return header ? header->sourceStamp : 0;
+}
+
+const SPackShape* CThemePack::shape(uint32_t index) {
+    if (!header || index >= header->shapeCount)
+        return nullptr;
+
+    return (const SPackShape*)(file.data() + header->shapesOffset) + index;
+}
+
+const SPackName* CThemePack::name(uint32_t index) {
+    if (!header || index >= header->nameCount)
+        return nullptr;
+
+    return (const SPackName*)(file.data() + header->namesOffset) + index;
+}
+
+const SPackRef* CThemePack::ref(uint32_t index) {
+    if (!header || index >= header->refCount)
+        return nullptr;
+
+    return (const SPackRef*)(file.data() + header->refsOffset) + index;
+}
+
+const SPackName* CThemePack::findName(std::string_view name_) {
+    if (!header)
+        return nullptr;
+
+    const auto NAMES = (const SPackName*)(file.data() + header->namesOffset);
+    const auto END   = NAMES + header->nameCount;
+
+    // a name out of bounds reads as empty, which can't be looked up
+    const auto IT = std::lower_bound(NAMES, END, name_, [this](const SPackName& n, std::string_view name) { return string(n.name, n.nameLen) < name; });
+
+    if (IT == END || IT->nameLen == 0 || string(IT->name, IT->nameLen) != name_)
+        return nullptr;
+
+    return IT;
+}
+
+const SPackFrame* CThemePack::frame(uint32_t index) {
+    if (!header || index >= header->frameCount)
+        return nullptr;
+
+    return (const SPackFrame*)(file.data() + header->framesOffset) + index;
+}
+
+std::string_view CThemePack::string(uint32_t offset, uint32_t len) {
+    if (!header || offset > header->stringsSize || len > header->stringsSize - offset)
+        return {};
+
+    return {(const char*)file.data() + header->stringsOffset + offset, len};
+}
+
+std::span<const uint8_t> CThemePack::payload(const SPackFrame& frame) {
+    if (!header || frame.offset > file.size() || frame.length > file.size() - frame.offset)
+        return {};
+
+    return {file.data() + frame.offset, frame.length};
+}
+
+static uint64_t alignUp(uint64_t value, uint64_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+static uint64_t fnv1a(uint64_t hash, const void* data, size_t len) {
+    for (size_t i = 0; i < len; ++i) {
+        hash ^= ((const uint8_t*)data)[i];
+        hash *= 0x100000001B3ULL;
+    }
+
+    return hash;
+}
+
+uint64_t CThemePack::sourceStamp(const std::string& cursorsDir) {
+    std::error_code ec;
+    auto            it = std::filesystem::directory_iterator(cursorsDir, ec);
+    if (ec)
+        return 0;
+
+    std::vector<std::filesystem::directory_entry> entries;
+    for (; it != std::filesystem::directory_iterator(); it.increment(ec)) {
+        if (ec)
+            return 0;
+
+        if (it->is_regular_file(ec))
+            entries.push_back(*it);
+    }
+
+    std::sort(entries.begin(), entries.end());
+
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    for (auto& e : entries) {
+        const auto NAME  = e.path().filename().string();
+        const auto SIZE  = (uint64_t)e.file_size(ec);
+        const auto MTIME = (int64_t)e.last_write_time(ec).time_since_epoch().count();
+
+        hash = fnv1a(hash, NAME.c_str(), NAME.size() + 1);
+        hash = fnv1a(hash, &SIZE, sizeof(SIZE));
+        hash = fnv1a(hash, &MTIME, sizeof(MTIME));
+    }
+
+    // 0 means unknown
+    return hash ? hash : 1;
+}
+
+std::optional<std::string> CThemePack::write(const std::string& path, const SCursorTheme& theme, const std::string& sourceDir, uint64_t stamp) {
+    std::string             strings;
+    std::vector<SPackShape> shapes;
+    std::vector<SPackName>  names;
+    std::vector<SPackRef>   refs;
+    std::vector<SPackFrame> frames;
+    std::vector<std::string> payloadPaths;
+
+    // every name, with the shapes that have it in theme and manifest order, which is also their priority
+    std::map<std::string, std::vector<SPackRef>> byName;
+
+    auto                    addString = [&strings](const std::string& s) -> uint32_t {
+        const auto OFFSET = strings.size();
+        strings += s;
+        return OFFSET;
+    };
+
+    for (size_t i = 0; i < theme.shapes.size(); ++i) {
+        const auto& SHAPE = theme.shapes[i];
+
+        SPackShape  packShape = {
+             .name        = addString(SHAPE->directory),
+             .nameLen     = (uint32_t)SHAPE->directory.size(),
+             .hotspotX    = SHAPE->hotspotX,
+             .hotspotY    = SHAPE->hotspotY,
+             .nominalSize = SHAPE->nominalSize,
+             .shapeType   = (uint8_t)SHAPE->shapeType,
+             .resizeAlgo  = (uint8_t)SHAPE->resizeAlgo,
+             .padding     = 0,
+             .firstFrame  = (uint32_t)frames.size(),
+             .frameCount  = (uint32_t)SHAPE->images.size(),
+        };
+
+        byName[SHAPE->directory].push_back(SPackRef{.shape = (uint32_t)i, .named = 1});
+
+        for (auto& o : SHAPE->overrides) {
+            byName[o].push_back(SPackRef{.shape = (uint32_t)i, .named = o == SHAPE->directory});
+        }
+
+        for (auto& image : SHAPE->images) {
+            const auto IMAGEPATH = sourceDir + "/" + SHAPE->directory + "/" + image.filename;
+
+            std::error_code ec;
+            const auto      LENGTH = std::filesystem::file_size(IMAGEPATH, ec);
+            if (ec)
+                return "failed to stat " + IMAGEPATH;
+
+            frames.push_back(SPackFrame{
+                .offset      = 0,
+                .length      = LENGTH,
+                .size        = image.size,
+                .delay       = image.delay,
+                .filename    = addString(image.filename),
+                .filenameLen = (uint32_t)image.filename.size(),
+            });
+
+            payloadPaths.push_back(IMAGEPATH);
+        }
+
+        shapes.push_back(packShape);
+    }
+
+    for (auto& [name, nameRefs] : byName) {
+        names.push_back(SPackName{.name = addString(name), .nameLen = (uint32_t)name.size(), .firstRef = (uint32_t)refs.size(), .refCount = (uint32_t)nameRefs.size()});
+        refs.insert(refs.end(), nameRefs.begin(), nameRefs.end());
+    }
+
+    SPackHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, PACK_MAGIC, sizeof(PACK_MAGIC));
+    header.version       = PACK_VERSION;
+    header.byteOrder     = PACK_BYTE_ORDER;
+    header.shapeCount    = shapes.size();
+    header.nameCount     = names.size();
+    header.refCount      = refs.size();
+    header.frameCount    = frames.size();
+    header.stringsSize   = strings.size();
+    header.sourceStamp   = stamp;
+    header.shapesOffset  = sizeof(SPackHeader);
+    header.namesOffset   = header.shapesOffset + shapes.size() * sizeof(SPackShape);
+    header.refsOffset    = header.namesOffset + names.size() * sizeof(SPackName);
+    header.framesOffset  = header.refsOffset + refs.size() * sizeof(SPackRef);
+    header.stringsOffset = header.framesOffset + frames.size() * sizeof(SPackFrame);
+
+    uint64_t end = header.stringsOffset + strings.size();
+    for (auto& f : frames) {
+        f.offset = alignUp(end, PACK_PAYLOAD_ALIGN);
+        end      = f.offset + f.length;
+    }
+
+    header.fileSize = end;
+
+    // write to a temporary file first, readers might have the old pack mapped
+    const auto    TMPPATH = path + ".tmp";
+    std::ofstream out(TMPPATH, std::ios::binary | std::ios::trunc);
+    if (!out.good())
+        return "failed to open " + TMPPATH + " for writing";
+
+    const auto fail = [&TMPPATH, &out](const std::string& err) {
+        out.close();
+        std::error_code ec;
+        std::filesystem::remove(TMPPATH, ec);
+        return err;
+    };
+
+    out.write((const char*)&header, sizeof(header));
+    out.write((const char*)shapes.data(), shapes.size() * sizeof(SPackShape));
+    out.write((const char*)names.data(), names.size() * sizeof(SPackName));
+    out.write((const char*)refs.data(), refs.size() * sizeof(SPackRef));
+    out.write((const char*)frames.data(), frames.size() * sizeof(SPackFrame));
+    out.write(strings.data(), strings.size());
+
+    std::vector<char> buffer;
+    for (size_t i = 0; i < frames.size(); ++i) {
+        // zero padding up to the payload
+        for (auto pos = (uint64_t)out.tellp(); pos < frames[i].offset; ++pos) {
+            out.put('\0');
+        }
+
+        std::ifstream in(payloadPaths[i], std::ios::binary);
+        buffer.resize(frames[i].length);
+        if (!in.read(buffer.data(), buffer.size()))
+            return fail("failed to read " + payloadPaths[i]);
+
+        out.write(buffer.data(), buffer.size());
+    }
+
+    out.close();
+
+    if (out.fail())
+        return fail("failed to write " + TMPPATH);
+
+    std::error_code ec;
+    std::filesystem::rename(TMPPATH, path, ec);
+    if (ec)
+        return fail("failed to move " + TMPPATH + " to " + path + ": " + ec.message());
+
+    return {};
+}
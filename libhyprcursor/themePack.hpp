@@ -0,0 +1,124 @@
+#pragma once
+
+#include <string>
+#include <optional>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <cstdint>
+
+#include "internalSharedTypes.hpp"
+#include "mappedFile.hpp"
+
+/*
+    A compiled theme in a single file, written by hyprcursor-util --pack
+    next to the cursors directory, as <cursors_directory>.hcpack
+
+    Layout, all integers in host byte order (checked with byteOrder):
+     - SPackHeader
+     - SPackShape[shapeCount], in theme order
+     - SPackName[nameCount], every shape name and override, sorted by name
+     - SPackRef[refCount], grouped by name, the shapes with that name in theme and manifest order,
+       so the first one has priority like it would when loading the archives
+     - SPackFrame[frameCount], grouped by shape
+     - string blob
+     - frame payloads (the png / svg files as-is), each aligned to PACK_PAYLOAD_ALIGN
+
+    sourceStamp is the sourceStamp() of the cursors directory the pack was made next to.
+    If it doesn't match anymore, the archives were changed after the pack was written.
+*/
+
+constexpr char     PACK_MAGIC[8]      = {'H', 'C', 'P', 'A', 'C', 'K', '\0', '\0'};
+constexpr uint32_t PACK_VERSION       = 3;
+constexpr uint32_t PACK_BYTE_ORDER    = 0x01020304;
+constexpr size_t   PACK_PAYLOAD_ALIGN = 64;
+
+struct SPackHeader {
+    char     magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint64_t fileSize;
+    uint32_t shapeCount;
+    uint32_t nameCount;
+    uint32_t refCount;
+    uint32_t frameCount;
+    uint32_t stringsSize;
+    uint32_t padding;
+    uint64_t sourceStamp;
+    uint64_t shapesOffset;
+    uint64_t namesOffset;
+    uint64_t refsOffset;
+    uint64_t framesOffset;
+    uint64_t stringsOffset;
+};
+
+struct SPackShape {
+    uint32_t name, nameLen; // directory, in the string blob
+    float    hotspotX, hotspotY, nominalSize;
+    uint8_t  shapeType;  // eShapeType
+    uint8_t  resizeAlgo; // eHyprcursorResizeAlgo
+    uint16_t padding;
+    uint32_t firstFrame, frameCount;
+};
+
+struct SPackName {
+    uint32_t name, nameLen;
+    uint32_t firstRef, refCount;
+};
+
+struct SPackRef {
+    uint32_t shape;
+    uint32_t named; // 1 if it's the shape's directory, 0 if the shape overrides it
+};
+
+struct SPackFrame {
+    uint64_t offset, length;
+    int32_t  size, delay;
+    uint32_t filename, filenameLen;
+};
+
+static_assert(sizeof(SPackHeader) == 96 && sizeof(SPackShape) == 32 && sizeof(SPackName) == 16 && sizeof(SPackRef) == 8 && sizeof(SPackFrame) == 32,
+              "pack records must not change size");
+
+/*
+    A mapped .hcpack. Only the header is checked when opening,
+    records are bounds-checked as they are read.
+*/
+class CThemePack {
+  public:
+    CThemePack(const std::string& path);
+
+    bool                       good();
+
+    uint32_t                   shapeCount();
+    uint32_t                   nameCount();
+    uint64_t                   sourceStamp();
+
+    const SPackShape*          shape(uint32_t index);
+    const SPackName*           name(uint32_t index);
+    const SPackRef*            ref(uint32_t index);
+    const SPackFrame*          frame(uint32_t index);
+
+    // binary search in the name table, nullptr if nothing is called name
+    const SPackName*           findName(std::string_view name);
+
+    // returns an empty view if out of bounds
+    std::string_view           string(uint32_t offset, uint32_t len);
+    std::span<const uint8_t>   payload(const SPackFrame& frame);
+
+    /*
+        Identifies the state of a cursors directory: a hash of its files' names, sizes and mtimes.
+        0 if it can't be read.
+    */
+    static uint64_t                   sourceStamp(const std::string& cursorsDir);
+
+    /*
+        Writes theme as a pack to path, reading the images from sourceDir/<shape>/<file>.
+        Shapes must have their overrides and images filled in. stamp is stored as the pack's sourceStamp.
+    */
+    static std::optional<std::string> write(const std::string& path, const SCursorTheme& theme, const std::string& sourceDir, uint64_t stamp);
+
+  private:
+    CMappedFile        file;
+    const SPackHeader* header = nullptr;
+};
@@ -0,0 +1,172 @@
+#include "themeWatcher.hpp"
+#include "themeIndex.hpp"
+#include "Log.hpp"
+
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+
+constexpr uint32_t ROOT_EVENTS   = IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_ATTRIB;
+constexpr uint32_t THEME_EVENTS  = IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_CLOSE_WRITE | IN_ATTRIB | IN_DELETE_SELF | IN_MOVE_SELF;
+constexpr uint32_t PARENT_EVENTS = IN_CREATE | IN_MOVED_TO;
+
+CThemeWatcher::CThemeWatcher(PHYPRCURSORLOGFUNC logFn_) : logFn(logFn_) {
+    inotifyFD = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+    if (inotifyFD < 0)
+        Debug::log(HC_LOG_ERR, logFn, "CThemeWatcher: inotify_init1 failed: {}", strerror(errno));
+}
+
+CThemeWatcher::~CThemeWatcher() {
+    if (inotifyFD >= 0)
+        close(inotifyFD);
+}
+
+bool CThemeWatcher::good() {
+    return inotifyFD >= 0;
+}
+
+int CThemeWatcher::fd() {
+    return inotifyFD;
+}
+
+void CThemeWatcher::removeWatches() {
+    for (auto& [wd, type] : watches) {
+        inotify_rm_watch(inotifyFD, wd);
+    }
+
+    watches.clear();
+}
+
+size_t CThemeWatcher::watchRoots() {
+    // parents are only needed until their root shows up
+    std::erase_if(watches, [this](const auto& e) {
+        if (e.second != WATCH_PARENT)
+            return false;
+
+        inotify_rm_watch(inotifyFD, e.first);
+        return true;
+    });
+
+    size_t missing = 0;
+
+    for (auto& root : getThemeSearchRoots()) {
+        const int WD = inotify_add_watch(inotifyFD, root.c_str(), ROOT_EVENTS | IN_ONLYDIR);
+        if (WD >= 0) {
+            watches.try_emplace(WD, WATCH_ROOT);
+            continue;
+        }
+
+        if (errno != ENOENT) {
+            Debug::log(HC_LOG_TRACE, logFn, "CThemeWatcher: not watching {}: {}", root, strerror(errno));
+            continue;
+        }
+
+        // e.g. ~/.local/share/icons before the first theme is installed
+        missing++;
+
+        std::error_code       ec;
+        std::filesystem::path parent = std::filesystem::path(root).parent_path();
+        while (parent.has_relative_path() && !std::filesystem::exists(parent, ec)) {
+            parent = parent.parent_path();
+        }
+
+        // added to whatever else watches the parent, if anything
+        const int PWD = inotify_add_watch(inotifyFD, parent.c_str(), PARENT_EVENTS | IN_ONLYDIR | IN_MASK_ADD);
+        if (PWD < 0) {
+            Debug::log(HC_LOG_TRACE, logFn, "CThemeWatcher: not watching {} for {}: {}", parent.string(), root, strerror(errno));
+            continue;
+        }
+
+        watches.try_emplace(PWD, WATCH_PARENT);
+    }
+
+    return missing;
+}
+
+void CThemeWatcher::watch(const std::string& themeDir, const std::string& cursorsDir) {
+    if (!good())
+        return;
+
+    removeWatches();
+
+    missingRoots = watchRoots();
+
+    for (auto& dir : {themeDir, cursorsDir}) {
+        if (dir.empty())
+            continue;
+
+        const int WD = inotify_add_watch(inotifyFD, dir.c_str(), THEME_EVENTS | IN_ONLYDIR);
+        if (WD < 0) {
+            Debug::log(HC_LOG_WARN, logFn, "CThemeWatcher: failed to watch {}: {}", dir, strerror(errno));
+            continue;
+        }
+
+        // roots and theme dirs can be the same inode, in which case the theme wins
+        watches[WD] = WATCH_THEME;
+    }
+
+    Debug::log(HC_LOG_TRACE, logFn, "CThemeWatcher: watching {} directories", watches.size());
+}
+
+uint32_t CThemeWatcher::dispatch() {
+    if (!good())
+        return HC_THEME_CHANGE_NONE;
+
+    uint32_t changes       = HC_THEME_CHANGE_NONE;
+    bool     parentChanged = false;
+
+    alignas(inotify_event) char buffer[4096];
+
+    while (true) {
+        const ssize_t LEN = read(inotifyFD, buffer, sizeof(buffer));
+
+        if (LEN <= 0)
+            break;
+
+        for (ssize_t offset = 0; offset < LEN;) {
+            const auto EVENT = (const inotify_event*)(buffer + offset);
+            offset += sizeof(inotify_event) + EVENT->len;
+
+            if (EVENT->mask & IN_Q_OVERFLOW) {
+                changes |= HC_THEME_CHANGE_CURRENT | HC_THEME_CHANGE_INSTALLED;
+                continue;
+            }
+
+            const auto IT = watches.find(EVENT->wd);
+            if (IT == watches.end())
+                continue;
+
+            if (EVENT->mask & IN_IGNORED) {
+                watches.erase(IT);
+                continue;
+            }
+
+            if (IT->second == WATCH_PARENT)
+                parentChanged = parentChanged || (EVENT->mask & IN_ISDIR);
+            else if (IT->second == WATCH_THEME)
+                changes |= HC_THEME_CHANGE_CURRENT;
+            else if (EVENT->mask & (IN_ISDIR | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO)) // symlinked themes come without IN_ISDIR
+                changes |= HC_THEME_CHANGE_INSTALLED;
+        }
+    }
+
+    // a missing root, or a directory on the way to it, appeared. Anything already in a new root is newly installed.
+    if (parentChanged) {
+        const size_t MISSING = watchRoots();
+
+        if (MISSING < missingRoots)
+            changes |= HC_THEME_CHANGE_INSTALLED;
+
+        missingRoots = MISSING;
+    }
+
+    if (changes != HC_THEME_CHANGE_NONE) {
+        Debug::log(HC_LOG_TRACE, logFn, "CThemeWatcher: got changes {}", changes);
+        lockThemeIndex(logFn)->invalidate();
+    }
+
+    return changes;
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+#include <unordered_map>
+#include <hyprcursor/shared.h>
+
+/*
+    Watches the theme search roots, and optionally a loaded theme,
+    with inotify.
+*/
+class CThemeWatcher {
+  public:
+    CThemeWatcher(PHYPRCURSORLOGFUNC logFn_);
+    ~CThemeWatcher();
+
+    // returns whether the inotify instance was created
+    bool good();
+
+    int  fd();
+
+    /*
+        (Re)creates all watches: the search roots, and if not empty,
+        the theme's directory and its cursors directory.
+
+        Roots that don't exist yet are watched for through their closest existing parent,
+        and watched themselves once they appear.
+    */
+    void watch(const std::string& themeDir, const std::string& cursorsDir);
+
+    /*
+        Reads all pending events, returns a mask of eHyprcursorThemeChange.
+    */
+    uint32_t dispatch();
+
+  private:
+    enum eWatchType : uint8_t {
+        WATCH_ROOT = 0,
+        WATCH_THEME,
+        WATCH_PARENT, // of a root that doesn't exist yet
+    };
+
+    void                                removeWatches();
+
+    // returns how many roots don't exist yet
+    size_t                              watchRoots();
+
+    int                                 inotifyFD = -1;
+    std::unordered_map<int, eWatchType> watches;
+    size_t                              missingRoots = 0;
+    PHYPRCURSORLOGFUNC                  logFn = nullptr;
+};
@@ -0,0 +1,130 @@
+/*
+    async_styles.cpp
+
+    Checks that a style loaded in the background is refcounted like any other,
+    can be released while it's loading, and once dispatched renders the same
+    as one loaded synchronously.
+*/
+
+#include <iostream>
+#include <chrono>
+#include <cstring>
+#include <poll.h>
+#include <hyprcursor/hyprcursor.hpp>
+
+void logFunction(enum eHyprcursorLogLevel level, char* message) {
+    std::cout << "[hc] " << message << "\n";
+}
+
+static bool samePixels(cairo_surface_t* a, cairo_surface_t* b) {
+    cairo_surface_flush(a);
+    cairo_surface_flush(b);
+
+    const auto STRIDE = cairo_image_surface_get_stride(a);
+    const auto HEIGHT = cairo_image_surface_get_height(a);
+
+    return STRIDE == cairo_image_surface_get_stride(b) && HEIGHT == cairo_image_surface_get_height(b) &&
+        std::memcmp(cairo_image_surface_get_data(a), cairo_image_surface_get_data(b), (size_t)STRIDE * HEIGHT) == 0;
+}
+
+int main(int argc, char** argv) {
+    Hyprcursor::CHyprcursorManager sync(nullptr, logFunction);
+    Hyprcursor::CHyprcursorManager mgr(nullptr, logFunction);
+
+    if (!sync.valid() || !mgr.valid()) {
+        std::cout << "mgr is invalid\n";
+        return 1;
+    }
+
+    const Hyprcursor::SCursorStyleInfo INFO{.size = 48};
+
+    const auto                         STYLE = mgr.acquireStyleAsync(INFO);
+    const auto                         OTHER = mgr.acquireStyleAsync(INFO);
+
+    if (!STYLE || STYLE != OTHER || !mgr.styleLoading(STYLE)) {
+        std::cout << "acquiring a loading style twice should give the same style\n";
+        return 1;
+    }
+
+    // nearest size available until it's rendered
+    if (mgr.getShapeView(STYLE, "left_ptr").empty()) {
+        std::cout << "left_ptr has no images while loading\n";
+        return 1;
+    }
+
+    // released while it's queued or loading, it's never dispatched
+    const auto CANCELLED = mgr.acquireStyleAsync({.size = 64});
+    if (!CANCELLED) {
+        std::cout << "failed acquiring a second style\n";
+        return 1;
+    }
+
+    mgr.releaseStyle(CANCELLED);
+
+    // one ref left
+    mgr.releaseStyle(OTHER);
+
+    if (!mgr.styleLoading(STYLE)) {
+        std::cout << "releasing one of two refs stopped the load\n";
+        return 1;
+    }
+
+    const auto   FD       = mgr.watchStyleLoads();
+    const auto   DEADLINE = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+    unsigned int finished = 0;
+
+    while (mgr.styleLoading(STYLE)) {
+        if (std::chrono::steady_clock::now() > DEADLINE) {
+            std::cout << "style didn't finish loading\n";
+            return 1;
+        }
+
+        pollfd pfd{.fd = FD, .events = POLLIN, .revents = 0};
+        poll(&pfd, 1, 100);
+
+        finished += mgr.dispatchStyleLoads();
+    }
+
+    if (finished != 1) {
+        std::cout << finished << " styles finished, expected only the one still acquired\n";
+        return 1;
+    }
+
+    if (!sync.loadThemeStyle(INFO)) {
+        std::cout << "failed loading style\n";
+        return 1;
+    }
+
+    const auto SYNC  = sync.getShape("left_ptr", INFO);
+    const auto ASYNC = mgr.getShapeView(STYLE, "left_ptr");
+
+    if (SYNC.images.empty() || SYNC.images.size() != ASYNC.size()) {
+        std::cout << "left_ptr has " << SYNC.images.size() << " images, but " << ASYNC.size() << " when loaded in the background\n";
+        return 1;
+    }
+
+    for (size_t i = 0; i < ASYNC.size(); ++i) {
+        const auto& S = SYNC.images[i];
+        const auto& A = ASYNC[i];
+
+        if (S.size != A.size || S.hotspotX != A.hotspotX || S.hotspotY != A.hotspotY || S.delay != A.delay || !samePixels(S.surface, A.surface)) {
+            std::cout << "left_ptr image " << i << " differs when loaded in the background\n";
+            return 1;
+        }
+    }
+
+    mgr.releaseStyle(STYLE);
+    sync.cursorSurfaceStyleDone(INFO);
+
+    // a manager going away mid load waits for the loader instead of leaving it reading freed sources
+    {
+        Hyprcursor::CHyprcursorManager shortLived(nullptr, logFunction);
+
+        if (!shortLived.valid() || !shortLived.acquireStyleAsync({.size = 32})) {
+            std::cout << "failed starting a load to abandon\n";
+            return 1;
+        }
+    }
+
+    return 0;
+}
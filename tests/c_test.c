@@ -68,6 +68,16 @@ int main(int argc, char** argv) {
     int ret = cairo_surface_write_to_png(data[0]->surface, "/tmp/arrowC.png");
 
     hyprcursor_cursor_image_data_free(data, dataSize);
+
+    // 32 at 1.5x lands on the style loaded above
+    struct hyprcursor_cursor_style_info logical = {.size = 32};
+    hyprcursor_style*                   style   = hyprcursor_style_acquire(mgr, logical, 1.5F);
+    if (!style || hyprcursor_style_get_info(mgr, style).size != 48 || hyprcursor_style_pixel_size(logical, 1.5F) != 48 || hyprcursor_style_pixel_size(logical, 0.F) != 32) {
+        printf("scaled style has the wrong pixel size\n");
+        return 1;
+    }
+
+    hyprcursor_style_release(mgr, style);
     hyprcursor_style_done(mgr, info);
 
     if (ret) {
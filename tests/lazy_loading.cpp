@@ -0,0 +1,91 @@
+/*
+    lazy_loading.cpp
+
+    Checks that a manager that loads lazily, and decodes on demand, returns
+    the same data as one that loads everything upfront.
+*/
+
+#include <iostream>
+#include <cstring>
+#include <hyprcursor/hyprcursor.hpp>
+
+void logFunction(enum eHyprcursorLogLevel level, char* message) {
+    std::cout << "[hc] " << message << "\n";
+}
+
+static bool sameRawData(const Hyprcursor::SCursorRawShapeData& a, const Hyprcursor::SCursorRawShapeData& b) {
+    if (a.images.size() != b.images.size() || a.overridenBy != b.overridenBy || a.hotspotX != b.hotspotX || a.hotspotY != b.hotspotY)
+        return false;
+
+    for (size_t i = 0; i < a.images.size(); ++i) {
+        if (a.images[i].data != b.images[i].data || a.images[i].size != b.images[i].size || a.images[i].delay != b.images[i].delay)
+            return false;
+    }
+
+    return true;
+}
+
+int main(int argc, char** argv) {
+    Hyprcursor::CHyprcursorManager eager(nullptr, logFunction);
+
+    Hyprcursor::SManagerLoadOptions options;
+    options.logFn          = logFunction;
+    options.lazyLoading    = true;
+    options.decodeOnDemand = true;
+
+    Hyprcursor::CHyprcursorManager lazy(nullptr, &options);
+
+    if (!eager.valid() || !lazy.valid()) {
+        std::cout << "mgr is invalid\n";
+        return 1;
+    }
+
+    // shapes are only read here, on first use
+    for (const char* shape : {"left_ptr", "text", "pointer"}) {
+        if (!sameRawData(eager.getRawShapeData(shape), lazy.getRawShapeData(shape))) {
+            std::cout << "raw data for " << shape << " differs when loaded lazily\n";
+            return 1;
+        }
+    }
+
+    Hyprcursor::SCursorStyleInfo style{.size = 48};
+    if (!eager.loadThemeStyle(style) || !lazy.loadThemeStyle(style)) {
+        std::cout << "failed loading style\n";
+        return 1;
+    }
+
+    const auto EAGER = eager.getShape("left_ptr", style);
+    const auto LAZY  = lazy.getShape("left_ptr", style);
+
+    if (EAGER.images.empty() || EAGER.images.size() != LAZY.images.size()) {
+        std::cout << "left_ptr has " << EAGER.images.size() << " images, but " << LAZY.images.size() << " when loaded lazily\n";
+        return 1;
+    }
+
+    for (size_t i = 0; i < EAGER.images.size(); ++i) {
+        const auto& E = EAGER.images[i];
+        const auto& L = LAZY.images[i];
+
+        if (E.size != L.size || E.hotspotX != L.hotspotX || E.hotspotY != L.hotspotY || E.delay != L.delay) {
+            std::cout << "left_ptr image " << i << " differs when loaded lazily\n";
+            return 1;
+        }
+
+        cairo_surface_flush(E.surface);
+        cairo_surface_flush(L.surface);
+
+        const auto STRIDE = cairo_image_surface_get_stride(E.surface);
+        const auto HEIGHT = cairo_image_surface_get_height(E.surface);
+
+        if (STRIDE != cairo_image_surface_get_stride(L.surface) || HEIGHT != cairo_image_surface_get_height(L.surface) ||
+            std::memcmp(cairo_image_surface_get_data(E.surface), cairo_image_surface_get_data(L.surface), (size_t)STRIDE * HEIGHT) != 0) {
+            std::cout << "left_ptr image " << i << " renders differently when loaded lazily\n";
+            return 1;
+        }
+    }
+
+    eager.cursorSurfaceStyleDone(style);
+    lazy.cursorSurfaceStyleDone(style);
+
+    return 0;
+}
@@ -0,0 +1,42 @@
+/*
+    list_themes.cpp
+
+    This example lists all installed hyprcursor themes,
+    e.g. for a settings UI, and loads the first one.
+*/
+
+#include <iostream>
+#include <hyprcursor/hyprcursor.hpp>
+
+void logFunction(enum eHyprcursorLogLevel level, char* message) {
+    std::cout << "[hc] " << message << "\n";
+}
+
+int main(int argc, char** argv) {
+    /*
+        Listing themes only reads their manifests,
+        no cursor shapes are loaded.
+    */
+    const auto THEMES = Hyprcursor::getThemes(logFunction);
+
+    if (THEMES.empty()) {
+        std::cout << "no themes found\n";
+        return 1;
+    }
+
+    for (auto& t : THEMES) {
+        std::cout << "theme " << t.name << " (" << t.directory << ") at " << t.path << ": " << t.description << "\n";
+    }
+
+    /*
+        Either the name or the directory can be used to create a manager.
+    */
+    Hyprcursor::CHyprcursorManager mgr(THEMES[0].directory.c_str(), logFunction);
+
+    if (!mgr.valid()) {
+        std::cout << "mgr is invalid\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,89 @@
+/*
+    resample.cpp
+
+    Checks that every resampler kernel this machine can run gives the same output
+    as the scalar one, for every algorithm, when reducing, enlarging and stretching.
+*/
+
+#include <iostream>
+#include <vector>
+#include <random>
+#include <cstring>
+#include <format>
+#include "resample.hpp"
+
+// premultiplied, so no channel is above alpha
+static std::vector<uint32_t> makeSource(int w, int h) {
+    std::vector<uint32_t> data((size_t)w * h);
+    std::mt19937          rng{1337};
+
+    for (auto& px : data) {
+        const uint32_t A = rng() % 4 == 0 ? 0 : rng() % 256;
+
+        px = A << 24;
+        for (int c = 0; c < 3; ++c) {
+            px |= (rng() % (A + 1)) << (c * 8);
+        }
+    }
+
+    return data;
+}
+
+int main(int argc, char** argv) {
+    const auto KERNELS = Resample::availableKernels();
+
+    std::cout << "kernels:";
+    for (auto& k : KERNELS) {
+        std::cout << " " << k;
+    }
+    std::cout << "\n";
+
+    struct SCase {
+        int srcW, srcH, dstW, dstH;
+    };
+
+    // widths that aren't a multiple of the simd ones leave tails for the scalar code
+    const std::vector<SCase> CASES = {{256, 256, 24, 24}, {256, 256, 48, 48}, {96, 96, 48, 48}, {48, 48, 64, 64}, {33, 33, 97, 97}, {40, 24, 32, 32}, {1, 1, 7, 7}};
+    bool                     ok    = true;
+
+    for (auto& c : CASES) {
+        const auto SOURCE = makeSource(c.srcW, c.srcH);
+
+        for (auto algo : {HC_RESIZE_NEAREST, HC_RESIZE_BILINEAR, HC_RESIZE_BOX, HC_RESIZE_LANCZOS}) {
+            std::vector<uint32_t> expected;
+
+            for (auto& k : KERNELS) {
+                if (!Resample::useKernels(k)) {
+                    std::cout << "can't use the " << k << " kernels, though they're listed\n";
+                    return 1;
+                }
+
+                std::vector<uint32_t> out((size_t)c.dstW * c.dstH);
+
+                if (!Resample::resample((const uint8_t*)SOURCE.data(), c.srcW, c.srcH, c.srcW * 4, (uint8_t*)out.data(), c.dstW, c.dstH, c.dstW * 4, algo)) {
+                    std::cout << std::format("{} failed {}x{}->{}x{} with algo {}\n", k, c.srcW, c.srcH, c.dstW, c.dstH, (int)algo);
+                    ok = false;
+                    continue;
+                }
+
+                // the first one is scalar
+                if (expected.empty()) {
+                    expected = std::move(out);
+                    continue;
+                }
+
+                if (std::memcmp(expected.data(), out.data(), out.size() * 4) != 0) {
+                    std::cout << std::format("{} differs from scalar for {}x{}->{}x{} with algo {}\n", k, c.srcW, c.srcH, c.dstW, c.dstH, (int)algo);
+                    ok = false;
+                }
+            }
+        }
+    }
+
+    if (Resample::useKernels("nothing")) {
+        std::cout << "unknown kernels were accepted\n";
+        ok = false;
+    }
+
+    return ok ? 0 : 1;
+}
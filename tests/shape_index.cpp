@@ -0,0 +1,121 @@
+/*
+    shape_index.cpp
+
+    Checks which shape a name resolves to when several shapes claim it:
+    the first one in theme order wins, whether it's the shape's own name or an override,
+    and a pack resolves every name the same way as the index built from the theme.
+*/
+
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <string>
+#include <memory>
+#include <cstdlib>
+#include "shapeIndex.hpp"
+#include "themePack.hpp"
+
+struct SExpected {
+    std::string name;
+    std::string shape, owner, overriddenBy; // empty for none
+    uint32_t    handle = 0;
+};
+
+static std::string directoryOf(SCursorShape* shape) {
+    return shape ? shape->directory : "";
+}
+
+static bool check(const CShapeIndex& index, const SExpected& e, const std::string& kind) {
+    const auto ENTRY = index.find(e.name);
+
+    if (!ENTRY) {
+        std::cout << kind << ": " << e.name << " not found\n";
+        return false;
+    }
+
+    if (directoryOf(ENTRY->shape) != e.shape || directoryOf(ENTRY->owner) != e.owner || directoryOf(ENTRY->overriddenBy) != e.overriddenBy || ENTRY->handle != e.handle) {
+        std::cout << kind << ": " << e.name << " resolves to " << directoryOf(ENTRY->shape) << " (owner " << directoryOf(ENTRY->owner) << ", overridden by "
+                  << directoryOf(ENTRY->overriddenBy) << ", handle " << ENTRY->handle << "), expected " << e.shape << " (owner " << e.owner << ", overridden by "
+                  << e.overriddenBy << ", handle " << e.handle << ")\n";
+        return false;
+    }
+
+    return true;
+}
+
+int main(int argc, char** argv) {
+    SCursorTheme theme;
+
+    const auto   addShape = [&theme](const std::string& name, std::vector<std::string> overrides) {
+        auto& shape      = theme.shapes.emplace_back(std::make_unique<SCursorShape>());
+        shape->directory = name;
+        shape->overrides = std::move(overrides);
+        shape->shapeType = SHAPE_PNG;
+        shape->images.push_back(SCursorImage{.filename = "32.png", .size = 32, .delay = 0});
+    };
+
+    // in theme order, which is the archives' sorted order
+    addShape("arrow", {"shared", "left_ptr"});
+    addShape("left_ptr", {"shared", "default"});
+    addShape("pointer", {"hand", "default", "pointer"});
+    addShape("text", {});
+
+    const std::vector<SExpected> EXPECTED = {
+        // overridden by an earlier shape, the override wins over the shape's own name
+        {.name = "left_ptr", .shape = "arrow", .owner = "left_ptr", .overriddenBy = "arrow", .handle = 1},
+        // two overrides, the earlier shape wins
+        {.name = "shared", .shape = "arrow", .owner = "", .overriddenBy = "arrow", .handle = 1},
+        {.name = "default", .shape = "left_ptr", .owner = "", .overriddenBy = "left_ptr", .handle = 2},
+        // overriding its own name changes nothing
+        {.name = "pointer", .shape = "pointer", .owner = "pointer", .overriddenBy = "", .handle = 3},
+        {.name = "hand", .shape = "pointer", .owner = "", .overriddenBy = "pointer", .handle = 3},
+        {.name = "text", .shape = "text", .owner = "text", .overriddenBy = "", .handle = 4},
+        {.name = "arrow", .shape = "arrow", .owner = "arrow", .overriddenBy = "", .handle = 1},
+    };
+
+    CShapeIndex index;
+    index.build(theme);
+
+    bool ok = index.size() == EXPECTED.size() && !index.find("nothing") && !index.find("");
+    if (!ok)
+        std::cout << "index has " << index.size() << " names, or finds names it shouldn't\n";
+
+    for (auto& e : EXPECTED) {
+        ok = check(index, e, "index") && ok;
+    }
+
+    // same from a pack
+    char tmpl[] = "/tmp/hyprcursor_shape_index_XXXXXX";
+    if (!mkdtemp(tmpl)) {
+        std::cout << "failed creating a temporary directory\n";
+        return 1;
+    }
+
+    const std::string ROOT = tmpl;
+
+    for (auto& shape : theme.shapes) {
+        std::filesystem::create_directories(ROOT + "/" + shape->directory);
+        std::ofstream(ROOT + "/" + shape->directory + "/32.png") << shape->directory;
+    }
+
+    if (const auto RET = CThemePack::write(ROOT + "/test.hcpack", theme, ROOT, 1); RET.has_value()) {
+        std::cout << "failed writing the pack: " << *RET << "\n";
+        ok = false;
+    } else {
+        CShapeIndex packIndex;
+        packIndex.build(theme, std::make_shared<CThemePack>(ROOT + "/test.hcpack"));
+
+        if (packIndex.size() != EXPECTED.size() || packIndex.find("nothing") || packIndex.find("")) {
+            std::cout << "pack has " << packIndex.size() << " names, or finds names it shouldn't\n";
+            ok = false;
+        }
+
+        for (auto& e : EXPECTED) {
+            ok = check(packIndex, e, "pack") && ok;
+        }
+    }
+
+    std::filesystem::remove_all(ROOT);
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,77 @@
+/*
+    theme_index.cpp
+
+    Checks that the on-disk theme index survives a save and a load:
+    a second index in the same environment uses the cached file
+    instead of rescanning, and finds the same theme with the same manifest.
+*/
+
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <string>
+#include <cstdlib>
+#include "themeIndex.hpp"
+
+static std::string logged;
+
+void               logFunction(enum eHyprcursorLogLevel level, char* message) {
+    std::cout << "[hc] " << message << "\n";
+    logged += message;
+    logged += "\n";
+}
+
+int main(int argc, char** argv) {
+    char tmpl[] = "/tmp/hyprcursor_index_XXXXXX";
+    if (!mkdtemp(tmpl)) {
+        std::cout << "failed creating a temporary directory\n";
+        return 1;
+    }
+
+    const std::string ROOT = tmpl;
+
+    // one theme, found by its manifest name, in an otherwise empty hierarchy
+    std::filesystem::create_directories(ROOT + "/home/.icons/dir_name");
+    std::filesystem::create_directories(ROOT + "/data/icons");
+    std::filesystem::create_directories(ROOT + "/cache");
+    std::ofstream(ROOT + "/home/.icons/dir_name/manifest.hl") << "name = Index Test\ndescription = round trip\ncursors_directory = hyprcursors\n";
+
+    setenv("HOME", (ROOT + "/home").c_str(), 1);
+    setenv("XDG_DATA_DIRS", (ROOT + "/data").c_str(), 1);
+    setenv("XDG_CACHE_HOME", (ROOT + "/cache").c_str(), 1);
+
+    int         ret = 0;
+    std::string firstPath;
+
+    {
+        CThemeIndex index(logFunction);
+        const auto  THEME = index.findTheme("Index Test");
+        if (!THEME) {
+            std::cout << "theme not found on a fresh scan\n";
+            ret = 1;
+        } else
+            firstPath = THEME->fullPath;
+    }
+
+    if (ret == 0) {
+        logged.clear();
+
+        CThemeIndex index(logFunction);
+        const auto  THEME = index.findTheme("Index Test");
+
+        if (logged.find("using cached index") == std::string::npos) {
+            std::cout << "the saved index wasn't loaded\n";
+            ret = 1;
+        } else if (logged.find("rescanning") != std::string::npos) {
+            std::cout << "the saved index was rescanned\n";
+            ret = 1;
+        } else if (!THEME || THEME->fullPath != firstPath || THEME->manifest.description != "round trip" || THEME->manifest.cursorsDirectory != "hyprcursors") {
+            std::cout << "the saved index doesn't match what was scanned\n";
+            ret = 1;
+        }
+    }
+
+    std::filesystem::remove_all(ROOT);
+
+    return ret;
+}
@@ -0,0 +1,225 @@
+/*
+    theme_pack.cpp
+
+    Checks that a theme written as a .hcpack reads back the same,
+    that broken packs are rejected, and that the manager falls back to
+    the cursors directory when the pack is broken or out of date.
+*/
+
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <zip.h>
+#include <hyprcursor/hyprcursor.hpp>
+#include "themePack.hpp"
+
+void logFunction(enum eHyprcursorLogLevel level, char* message) {
+    std::cout << "[hc] " << message << "\n";
+}
+
+static std::string readFile(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    return {std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+}
+
+static void writePng(const std::string& path, int side) {
+    const auto SURFACE = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, side, side);
+    const auto CAIRO   = cairo_create(SURFACE);
+    cairo_set_source_rgba(CAIRO, 1, 0, 0, 1);
+    cairo_paint(CAIRO);
+    cairo_destroy(CAIRO);
+    cairo_surface_write_to_png(SURFACE, path.c_str());
+    cairo_surface_destroy(SURFACE);
+}
+
+// the archives say shapes override from_archives, the pack says from_pack, so either tells where the theme came from
+static bool writeArchive(const std::string& path, const std::string& sourceDir, const std::string& shape) {
+    static std::vector<std::string> metas;
+    metas.emplace_back("resize_algorithm = bilinear\ndefine_size = 32, 32.png\ndefine_override = from_archives\n");
+
+    int    errp = 0;
+    zip_t* zip  = zip_open(path.c_str(), ZIP_CREATE | ZIP_TRUNCATE, &errp);
+    if (!zip)
+        return false;
+
+    const auto META  = zip_source_buffer(zip, metas.back().data(), metas.back().size(), 0);
+    const auto IMAGE = zip_source_file(zip, (sourceDir + "/" + shape + "/32.png").c_str(), 0, ZIP_LENGTH_TO_END);
+
+    if (!META || zip_file_add(zip, "meta.hl", META, ZIP_FL_ENC_UTF_8) < 0 || !IMAGE || zip_file_add(zip, "32.png", IMAGE, ZIP_FL_ENC_UTF_8) < 0) {
+        zip_discard(zip);
+        return false;
+    }
+
+    return zip_close(zip) == 0;
+}
+
+static SCursorTheme makeTheme() {
+    SCursorTheme theme;
+
+    for (const char* name : {"left_ptr", "text"}) {
+        auto& shape       = theme.shapes.emplace_back(std::make_unique<SCursorShape>());
+        shape->directory  = name;
+        shape->hotspotX   = 0.25F;
+        shape->hotspotY   = 0.5F;
+        shape->resizeAlgo = HC_RESIZE_BILINEAR;
+        shape->shapeType  = SHAPE_PNG;
+        shape->images.push_back(SCursorImage{.filename = "32.png", .size = 32, .delay = 100});
+        shape->overrides.push_back("from_pack");
+    }
+
+    return theme;
+}
+
+// where the manager got the theme from, by which of the two overrides it knows
+static std::string loadedFrom() {
+    Hyprcursor::CHyprcursorManager mgr("Pack Test", logFunction);
+
+    if (!mgr.valid())
+        return "nothing";
+
+    const bool PACK     = mgr.getShapeHandle("from_pack") != 0;
+    const bool ARCHIVES = mgr.getShapeHandle("from_archives") != 0;
+
+    if (PACK == ARCHIVES)
+        return "both";
+
+    return PACK ? "pack" : "archives";
+}
+
+static bool check(bool condition, const std::string& what) {
+    if (!condition)
+        std::cout << "FAILED: " << what << "\n";
+
+    return condition;
+}
+
+int main(int argc, char** argv) {
+    char tmpl[] = "/tmp/hyprcursor_pack_XXXXXX";
+    if (!mkdtemp(tmpl)) {
+        std::cout << "failed creating a temporary directory\n";
+        return 1;
+    }
+
+    const std::string ROOT       = tmpl;
+    const std::string SOURCE     = ROOT + "/source";
+    const std::string THEME      = ROOT + "/home/.icons/pack_test";
+    const std::string CURSORSDIR = THEME + "/hyprcursors";
+    const std::string PACKPATH   = CURSORSDIR + ".hcpack";
+
+    std::filesystem::create_directories(CURSORSDIR);
+    std::filesystem::create_directories(ROOT + "/data/icons");
+    std::filesystem::create_directories(ROOT + "/cache");
+    std::ofstream(THEME + "/manifest.hl") << "name = Pack Test\ndescription = pack test\ncursors_directory = hyprcursors\n";
+
+    setenv("HOME", (ROOT + "/home").c_str(), 1);
+    setenv("XDG_DATA_DIRS", (ROOT + "/data").c_str(), 1);
+    setenv("XDG_CACHE_HOME", (ROOT + "/cache").c_str(), 1);
+
+    const auto THEMEDATA = makeTheme();
+    bool       ok        = true;
+
+    for (auto& shape : THEMEDATA.shapes) {
+        std::filesystem::create_directories(SOURCE + "/" + shape->directory);
+        writePng(SOURCE + "/" + shape->directory + "/32.png", 32);
+        ok = ok && check(writeArchive(CURSORSDIR + "/" + shape->directory + ".hlc", SOURCE, shape->directory), "writing " + shape->directory + ".hlc");
+    }
+
+    const auto STAMP = CThemePack::sourceStamp(CURSORSDIR);
+    ok               = ok && check(!CThemePack::write(PACKPATH, THEMEDATA, SOURCE, STAMP).has_value(), "writing the pack");
+
+    // round trip
+    if (ok) {
+        CThemePack pack(PACKPATH);
+
+        ok = check(pack.good(), "the written pack is valid") && check(pack.shapeCount() == 2, "the pack has both shapes") &&
+            check(pack.sourceStamp() == STAMP && STAMP != 0, "the pack keeps its stamp");
+
+        for (uint32_t i = 0; ok && i < pack.shapeCount(); ++i) {
+            const auto& SHAPE = THEMEDATA.shapes[i];
+            const auto  PACKSHAPE = pack.shape(i);
+
+            ok = check(pack.string(PACKSHAPE->name, PACKSHAPE->nameLen) == SHAPE->directory, "shape " + SHAPE->directory + " keeps its name") &&
+                check(PACKSHAPE->hotspotX == SHAPE->hotspotX && PACKSHAPE->hotspotY == SHAPE->hotspotY && PACKSHAPE->resizeAlgo == SHAPE->resizeAlgo,
+                      "shape " + SHAPE->directory + " keeps its metadata") &&
+                check(PACKSHAPE->frameCount == 1, "shape " + SHAPE->directory + " has its frame");
+
+            const auto FRAME = ok ? pack.frame(PACKSHAPE->firstFrame) : nullptr;
+            const auto DATA  = FRAME ? pack.payload(*FRAME) : std::span<const uint8_t>{};
+
+            ok = ok && check(FRAME && FRAME->size == 32 && FRAME->delay == 100, "frame of " + SHAPE->directory + " keeps its size and delay") &&
+                check(std::string((const char*)DATA.data(), DATA.size()) == readFile(SOURCE + "/" + SHAPE->directory + "/32.png"), "frame of " + SHAPE->directory + " keeps its data");
+
+            const auto NAME = pack.findName(SHAPE->directory);
+            ok              = ok && check(NAME && NAME->refCount == 1 && pack.ref(NAME->firstRef)->shape == i && pack.ref(NAME->firstRef)->named, SHAPE->directory + " is found by name");
+        }
+
+        // both shapes override it, the first one in theme order comes first
+        const auto OVERRIDE = pack.findName("from_pack");
+        ok = ok && check(OVERRIDE && OVERRIDE->refCount == 2 && pack.ref(OVERRIDE->firstRef)->shape == 0 && !pack.ref(OVERRIDE->firstRef)->named, "overrides are kept in priority order");
+        ok = ok && check(!pack.findName("from_archives") && !pack.findName("") && !pack.findName("zzz"), "unknown names aren't found");
+    }
+
+    ok = ok && check(loadedFrom() == "pack", "an up to date pack is preferred");
+
+    const auto GOOD = readFile(PACKPATH);
+
+    // out of date: an archive changed after the pack was written
+    if (ok) {
+        const auto ARCHIVE = CURSORSDIR + "/text.hlc";
+        std::filesystem::last_write_time(ARCHIVE, std::filesystem::last_write_time(ARCHIVE) + std::chrono::hours(1));
+
+        ok = check(CThemePack::sourceStamp(CURSORSDIR) != STAMP, "changing an archive changes the stamp") && check(loadedFrom() == "archives", "an out of date pack is ignored");
+
+        std::filesystem::last_write_time(ARCHIVE, std::filesystem::last_write_time(ARCHIVE) - std::chrono::hours(1));
+        ok = ok && check(loadedFrom() == "pack", "the pack is used again once the stamp matches");
+    }
+
+    // corrupt packs are rejected, and the archives loaded instead
+    const auto corrupt = [&](const std::string& what, bool opens, auto&& fn) {
+        std::string data = GOOD;
+        fn(data);
+        std::ofstream(PACKPATH, std::ios::binary | std::ios::trunc) << data;
+
+        return check(CThemePack(PACKPATH).good() == opens, "a pack with a broken " + what + (opens ? " opens" : " is rejected when opening")) &&
+            check(loadedFrom() == "archives", "the archives are loaded instead of a pack with a broken " + what);
+    };
+
+    ok = ok && corrupt("magic", false, [](std::string& d) { d[0] = 'X'; });
+    ok = ok && corrupt("size", false, [](std::string& d) { d.resize(d.size() / 2); });
+    ok = ok && corrupt("version", false, [](std::string& d) { ((SPackHeader*)d.data())->version = PACK_VERSION + 1; });
+    ok = ok && corrupt("name table", false, [](std::string& d) { ((SPackHeader*)d.data())->namesOffset = d.size() - 1; });
+    // only the loader knows which algorithms exist
+    ok = ok && corrupt("resize algorithm", true, [](std::string& d) {
+        const auto HEADER = (const SPackHeader*)d.data();
+        d[HEADER->shapesOffset + offsetof(SPackShape, resizeAlgo)] = (char)200;
+    });
+
+    // a name pointing past the strings reads as nothing, instead of out of bounds
+    if (ok) {
+        std::string data   = GOOD;
+        const auto  HEADER = (const SPackHeader*)data.data();
+        ((SPackName*)(data.data() + HEADER->namesOffset))->nameLen = 0xFFFFFF;
+        std::ofstream(PACKPATH, std::ios::binary | std::ios::trunc) << data;
+
+        CThemePack pack(PACKPATH);
+        ok = check(pack.good(), "a pack with a broken name opens") && check(!pack.findName("from_pack"), "the broken name isn't found") &&
+            check(pack.findName("left_ptr") && pack.findName("text"), "other names are still found");
+    }
+
+    // a theme shipping only the pack
+    if (ok) {
+        std::ofstream(PACKPATH, std::ios::binary | std::ios::trunc) << GOOD;
+        std::filesystem::remove_all(CURSORSDIR);
+
+        ok = check(loadedFrom() == "pack", "a pack without a cursors directory is used");
+    }
+
+    std::filesystem::remove_all(ROOT);
+
+    return ok ? 0 : 1;
+}